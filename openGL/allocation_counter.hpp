@@ -0,0 +1,85 @@
+//
+//  allocation_counter.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef allocation_counter_h
+#define allocation_counter_h
+
+// System Includes
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Builds with OPENGL_COUNT_ALLOCATIONS replace the global operator new to count every heap allocation made by any
+// thread, so the render loop can flag frames that allocate. Other builds leave the allocator alone
+#ifdef OPENGL_COUNT_ALLOCATIONS
+const bool HEAP_ALLOCATIONS_COUNTED = true;
+#else
+const bool HEAP_ALLOCATIONS_COUNTED = false;
+#endif
+
+// Heap allocations made through operator new since startup
+inline std::atomic<std::size_t>& heap_allocation_counter() {
+  static std::atomic<std::size_t> counter(0);
+  return counter;
+}
+
+inline std::size_t get_heap_allocation_count() {
+  return heap_allocation_counter().load(std::memory_order_relaxed);
+}
+
+// Define ALLOCATION_COUNTER_IMPLEMENTATION in exactly one translation unit before including this file
+#if defined(ALLOCATION_COUNTER_IMPLEMENTATION) && defined(OPENGL_COUNT_ALLOCATIONS)
+void* operator new(const std::size_t size) {
+  heap_allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  void *memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](const std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+  heap_allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](const std::size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+#endif
+
+#endif /* allocation_counter_h */
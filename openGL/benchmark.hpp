@@ -0,0 +1,292 @@
+//
+//  benchmark.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef benchmark_h
+#define benchmark_h
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Local Includes
+#include "camera.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
+
+// Scripted camera motion. The pose only depends on the frame index, so every run sees exactly the same frames
+enum CameraPathType {
+  ORBIT,
+  FLY_THROUGH
+};
+
+class CameraPath {
+
+public:
+  // Ctor
+  CameraPath(const CameraPathType type, const std::size_t frame_count)
+  : type_(type),
+    frame_count_(frame_count == 0 ? 1 : frame_count) {}
+
+  static bool parse(const std::string &name, CameraPathType &type) {
+    if (name == "orbit") {
+      type = ORBIT;
+    }
+    else if (name == "flythrough") {
+      type = FLY_THROUGH;
+    }
+    else {
+      return false;
+    }
+    return true;
+  }
+
+  void apply(Camera &camera, const std::size_t frame) const {
+    const float t = static_cast<float>(frame % frame_count_) / static_cast<float>(frame_count_);
+
+    if (type_ == ORBIT) {
+      // One full turn around the container field, always looking at its middle
+      const glm::vec3 center(0.0f, 0.0f, -6.0f);
+      const float angle = t * 2.0f * glm::pi<float>();
+      const glm::vec3 position = center + glm::vec3(std::cos(angle) * 12.0f, 2.0f, std::sin(angle) * 12.0f);
+      const glm::vec3 direction = glm::normalize(center - position);
+      camera.set_pose(position, glm::degrees(std::atan2(direction.z, direction.x)),
+                      glm::degrees(std::asin(direction.y)));
+    }
+    else {
+      // Straight down the field from the front, with a slow sweep from side to side
+      const glm::vec3 position(0.0f, 0.5f, 3.0f - t * 40.0f);
+      camera.set_pose(position, -90.0f + std::sin(t * 4.0f * glm::pi<float>()) * 30.0f, -5.0f);
+    }
+  }
+
+private:
+  CameraPathType type_;
+  std::size_t frame_count_;
+};
+
+// GPU time per frame from GL_TIME_ELAPSED queries. Results are read a few frames late from a ring of queries
+// so the CPU never waits on the GPU to finish
+class GpuFrameTimer {
+
+public:
+  // Ctor
+  GpuFrameTimer() {
+    glGenQueries(LATENCY, queries_);
+  }
+
+  // Dtor
+  ~GpuFrameTimer() {
+    glDeleteQueries(LATENCY, queries_);
+  }
+
+  GpuFrameTimer(const GpuFrameTimer&) = delete;
+  GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+
+  // Starts timing a frame. If the query slot is still holding an old result it is read first, which only
+  // waits when the GPU is more than LATENCY frames behind
+  template <typename Callback>
+  void begin(const std::size_t frame, Callback callback) {
+    const std::size_t slot = frame % LATENCY;
+    if (pending_[slot]) {
+      read(slot, callback);
+    }
+    frames_[slot] = frame;
+    glBeginQuery(GL_TIME_ELAPSED, queries_[slot]);
+  }
+
+  void end(const std::size_t frame) {
+    glEndQuery(GL_TIME_ELAPSED);
+    pending_[frame % LATENCY] = true;
+  }
+
+  // Hands every finished result to callback as (frame, milliseconds). With wait set, blocks for all of them
+  template <typename Callback>
+  void poll(Callback callback, const bool wait = false) {
+    for (std::size_t slot = 0; slot < LATENCY; slot++) {
+      if (!pending_[slot]) {
+        continue;
+      }
+
+      int available = 0;
+      glGetQueryObjectiv(queries_[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+      if (available || wait) {
+        read(slot, callback);
+      }
+    }
+  }
+
+private:
+  static const std::size_t LATENCY = 4;
+
+  unsigned int queries_[LATENCY] = {};
+  std::size_t frames_[LATENCY] = {};
+  bool pending_[LATENCY] = {};
+
+  template <typename Callback>
+  void read(const std::size_t slot, Callback callback) {
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries_[slot], GL_QUERY_RESULT, &nanoseconds);
+    pending_[slot] = false;
+    callback(frames_[slot], static_cast<double>(nanoseconds) / 1.0e6);
+  }
+};
+
+struct FrameRecord {
+  double cpu_ms = 0.0;
+  double gpu_ms = -1.0;
+  std::size_t draw_calls = 0;
+  std::size_t uniform_calls = 0;
+  std::size_t drawn_objects = 0;
+  std::size_t culled_objects = 0;
+  std::size_t state_calls = 0;
+  std::size_t skipped_state_calls = 0;
+  std::size_t heap_allocations = 0;
+};
+
+struct Percentiles {
+  double p50 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+  double mean = 0.0;
+};
+
+// Collects one record per frame and summarizes them
+class BenchmarkRecorder {
+
+public:
+  explicit BenchmarkRecorder(const std::size_t frame_count) {
+    frames_.reserve(frame_count);
+  }
+
+  FrameRecord& add_frame() {
+    frames_.push_back(FrameRecord());
+    return frames_.back();
+  }
+
+  void set_gpu_time(const std::size_t frame, const double gpu_ms) {
+    if (frame < frames_.size()) {
+      frames_[frame].gpu_ms = gpu_ms;
+    }
+  }
+
+  std::size_t size() const {
+    return frames_.size();
+  }
+
+  // Nearest-rank percentiles. Frames without a value, such as GPU times that never came back, are skipped
+  template <typename Getter>
+  Percentiles summarize(Getter getter) const {
+    std::vector<double> values;
+    values.reserve(frames_.size());
+    for (const FrameRecord &frame : frames_) {
+      const double value = getter(frame);
+      if (value >= 0.0) {
+        values.push_back(value);
+      }
+    }
+
+    Percentiles result;
+    if (values.empty()) {
+      return result;
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto rank = [&values](const double percentile) {
+      const std::size_t index = static_cast<std::size_t>(std::ceil(percentile * values.size()));
+      return values[std::min(values.size() - 1, index == 0 ? 0 : index - 1)];
+    };
+    result.p50 = rank(0.50);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+
+    double total = 0.0;
+    for (const double value : values) {
+      total += value;
+    }
+    result.mean = total / values.size();
+    return result;
+  }
+
+  void print_summary(std::ostream &out) const {
+    const Percentiles cpu = summarize([](const FrameRecord &frame) { return frame.cpu_ms; });
+    const Percentiles gpu = summarize([](const FrameRecord &frame) { return frame.gpu_ms; });
+    const Percentiles draws = summarize([](const FrameRecord &frame) { return static_cast<double>(frame.draw_calls); });
+    const Percentiles uniforms = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.uniform_calls);
+    });
+    const Percentiles drawn = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.drawn_objects);
+    });
+    const Percentiles culled = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.culled_objects);
+    });
+    const Percentiles state = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.state_calls);
+    });
+    const Percentiles skipped = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.skipped_state_calls);
+    });
+    const Percentiles allocations = summarize([](const FrameRecord &frame) {
+      return static_cast<double>(frame.heap_allocations);
+    });
+
+    out << "Benchmark: " << frames_.size() << " frames\n";
+    out << "  CPU ms   p50 " << cpu.p50 << "  p95 " << cpu.p95 << "  p99 " << cpu.p99 << "  mean " << cpu.mean << "\n";
+    out << "  GPU ms   p50 " << gpu.p50 << "  p95 " << gpu.p95 << "  p99 " << gpu.p99 << "  mean " << gpu.mean << "\n";
+    out << "  Draw calls per frame " << draws.mean << ", uniform calls per frame " << uniforms.mean << "\n";
+    out << "  Objects per frame drawn " << drawn.mean << ", culled " << culled.mean << "\n";
+    out << "  State calls per frame issued " << state.mean << ", skipped " << skipped.mean << "\n";
+    out << "  Heap allocations per frame mean " << allocations.mean << ", p99 " << allocations.p99 << "\n";
+  }
+
+  // Writes every frame as CSV, or as JSON when the path ends in .json
+  bool write_trace(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+      std::cerr << "Could not write " << path << "\n";
+      return false;
+    }
+
+    const bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) {
+      file << "{\"frames\":[\n";
+      for (std::size_t i = 0; i < frames_.size(); i++) {
+        const FrameRecord &frame = frames_[i];
+        file << "  {\"frame\":" << i << ",\"cpu_ms\":" << frame.cpu_ms << ",\"gpu_ms\":" << frame.gpu_ms
+             << ",\"draw_calls\":" << frame.draw_calls << ",\"uniform_calls\":" << frame.uniform_calls
+             << ",\"drawn_objects\":" << frame.drawn_objects << ",\"culled_objects\":" << frame.culled_objects
+             << ",\"state_calls\":" << frame.state_calls << ",\"skipped_state_calls\":" << frame.skipped_state_calls
+             << ",\"heap_allocations\":" << frame.heap_allocations << "}"
+             << (i + 1 < frames_.size() ? ",\n" : "\n");
+      }
+      file << "]}\n";
+    }
+    else {
+      file << "frame,cpu_ms,gpu_ms,draw_calls,uniform_calls,drawn_objects,culled_objects,state_calls,"
+           << "skipped_state_calls,heap_allocations\n";
+      for (std::size_t i = 0; i < frames_.size(); i++) {
+        const FrameRecord &frame = frames_[i];
+        file << i << "," << frame.cpu_ms << "," << frame.gpu_ms << "," << frame.draw_calls << ","
+             << frame.uniform_calls << "," << frame.drawn_objects << "," << frame.culled_objects << ","
+             << frame.state_calls << "," << frame.skipped_state_calls << "," << frame.heap_allocations << "\n";
+      }
+    }
+    return true;
+  }
+
+private:
+  std::vector<FrameRecord> frames_;
+};
+
+#endif /* benchmark_h */
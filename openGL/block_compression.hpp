@@ -0,0 +1,579 @@
+//
+//  block_compression.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef block_compression_h
+#define block_compression_h
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Local Includes
+#include "ktx.hpp"
+
+// Offline encoders for the block compressed formats in ktx.hpp. Each one takes a 4x4 block of RGBA8 texels in
+// row major order. They aim for reasonable quality at a reasonable speed, not for the best possible encoding
+
+namespace block_compression {
+
+inline int clamp_byte(const int value) {
+  return std::min(255, std::max(0, value));
+}
+
+inline std::uint16_t pack_565(const float r, const float g, const float b) {
+  const int r5 = std::min(31, std::max(0, static_cast<int>(r * 31.0f / 255.0f + 0.5f)));
+  const int g6 = std::min(63, std::max(0, static_cast<int>(g * 63.0f / 255.0f + 0.5f)));
+  const int b5 = std::min(31, std::max(0, static_cast<int>(b * 31.0f / 255.0f + 0.5f)));
+  return static_cast<std::uint16_t>((r5 << 11) | (g6 << 5) | b5);
+}
+
+inline void unpack_565(const std::uint16_t color, int rgb[3]) {
+  const int r5 = (color >> 11) & 31;
+  const int g6 = (color >> 5) & 63;
+  const int b5 = color & 31;
+  rgb[0] = (r5 << 3) | (r5 >> 2);
+  rgb[1] = (g6 << 2) | (g6 >> 4);
+  rgb[2] = (b5 << 3) | (b5 >> 2);
+}
+
+// BC1: two 565 endpoints along the principal axis of the block's colors and a 2-bit index per texel
+inline void encode_bc1(const unsigned char block[64], unsigned char out[8]) {
+  float mean[3] = {0.0f, 0.0f, 0.0f};
+  for (int i = 0; i < 16; i++) {
+    for (int c = 0; c < 3; c++) {
+      mean[c] += block[i * 4 + c] / 16.0f;
+    }
+  }
+
+  float covariance[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  for (int i = 0; i < 16; i++) {
+    const float r = block[i * 4 + 0] - mean[0];
+    const float g = block[i * 4 + 1] - mean[1];
+    const float b = block[i * 4 + 2] - mean[2];
+    covariance[0] += r * r;
+    covariance[1] += r * g;
+    covariance[2] += r * b;
+    covariance[3] += g * g;
+    covariance[4] += g * b;
+    covariance[5] += b * b;
+  }
+
+  // Power iteration for the principal axis
+  float axis[3] = {1.0f, 1.0f, 1.0f};
+  for (int iteration = 0; iteration < 8; iteration++) {
+    const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+    const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+    const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+    const float length = std::max(std::abs(x), std::max(std::abs(y), std::abs(z)));
+    if (length <= 0.0f) {
+      break;
+    }
+    axis[0] = x / length;
+    axis[1] = y / length;
+    axis[2] = z / length;
+  }
+
+  float min_t = std::numeric_limits<float>::max();
+  float max_t = -std::numeric_limits<float>::max();
+  for (int i = 0; i < 16; i++) {
+    const float t = (block[i * 4 + 0] - mean[0]) * axis[0] + (block[i * 4 + 1] - mean[1]) * axis[1] +
+                    (block[i * 4 + 2] - mean[2]) * axis[2];
+    min_t = std::min(min_t, t);
+    max_t = std::max(max_t, t);
+  }
+
+  // Pull the endpoints in slightly, the extremes are usually outliers
+  const float length_sq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+  const float inset = (max_t - min_t) / 16.0f;
+  min_t = (min_t + inset) / std::max(length_sq, 1e-6f);
+  max_t = (max_t - inset) / std::max(length_sq, 1e-6f);
+
+  std::uint16_t c0 = pack_565(mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t, mean[2] + axis[2] * max_t);
+  std::uint16_t c1 = pack_565(mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t, mean[2] + axis[2] * min_t);
+
+  // c0 > c1 selects the four color mode
+  if (c0 < c1) {
+    std::swap(c0, c1);
+  }
+
+  int palette[4][3];
+  unpack_565(c0, palette[0]);
+  unpack_565(c1, palette[1]);
+  for (int c = 0; c < 3; c++) {
+    palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+    palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+  }
+
+  std::uint32_t indices = 0;
+  if (c0 != c1) {
+    for (int i = 0; i < 16; i++) {
+      int best = 0;
+      int best_error = std::numeric_limits<int>::max();
+      for (int p = 0; p < 4; p++) {
+        const int dr = block[i * 4 + 0] - palette[p][0];
+        const int dg = block[i * 4 + 1] - palette[p][1];
+        const int db = block[i * 4 + 2] - palette[p][2];
+        const int error = dr * dr + dg * dg + db * db;
+        if (error < best_error) {
+          best_error = error;
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint32_t>(best) << (i * 2);
+    }
+  }
+
+  out[0] = static_cast<unsigned char>(c0 & 0xFF);
+  out[1] = static_cast<unsigned char>(c0 >> 8);
+  out[2] = static_cast<unsigned char>(c1 & 0xFF);
+  out[3] = static_cast<unsigned char>(c1 >> 8);
+  for (int i = 0; i < 4; i++) {
+    out[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+  }
+}
+
+// BC4: one channel between two 8-bit endpoints with a 3-bit index per texel. Used for BC3 alpha and BC5
+inline void encode_bc4(const unsigned char block[64], const int channel, unsigned char out[8]) {
+  int low = 255;
+  int high = 0;
+  for (int i = 0; i < 16; i++) {
+    low = std::min(low, static_cast<int>(block[i * 4 + channel]));
+    high = std::max(high, static_cast<int>(block[i * 4 + channel]));
+  }
+
+  // a0 > a1 selects the eight value mode, a flat block just repeats index 0
+  int palette[8];
+  palette[0] = high;
+  palette[1] = low;
+  for (int p = 2; p < 8; p++) {
+    palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+  }
+
+  std::uint64_t indices = 0;
+  if (high != low) {
+    for (int i = 0; i < 16; i++) {
+      int best = 0;
+      int best_error = std::numeric_limits<int>::max();
+      for (int p = 0; p < 8; p++) {
+        const int error = std::abs(block[i * 4 + channel] - palette[p]);
+        if (error < best_error) {
+          best_error = error;
+          best = p;
+        }
+      }
+      indices |= static_cast<std::uint64_t>(best) << (i * 3);
+    }
+  }
+
+  out[0] = static_cast<unsigned char>(high);
+  out[1] = static_cast<unsigned char>(low);
+  for (int i = 0; i < 6; i++) {
+    out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+  }
+}
+
+// BC3: BC4 alpha followed by BC1 color
+inline void encode_bc3(const unsigned char block[64], unsigned char out[16]) {
+  encode_bc4(block, 3, out);
+  encode_bc1(block, out + 8);
+}
+
+// BC5: BC4 red followed by BC4 green, meant for tangent space normal maps
+inline void encode_bc5(const unsigned char block[64], unsigned char out[16]) {
+  encode_bc4(block, 0, out);
+  encode_bc4(block, 1, out + 8);
+}
+
+// ETC1 modifier tables, shared with the individual and differential modes of ETC2
+const int ETC_MODIFIERS[8][2] = {{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+// Best table and per-texel modifier indices for one half of an ETC block around base. Returns the squared error
+inline int fit_etc_subblock(const unsigned char block[64], const int texels[8], const int base[3], int &table,
+                            int selectors[8]) {
+  int best_error = std::numeric_limits<int>::max();
+  for (int t = 0; t < 8; t++) {
+    const int modifiers[4] = {ETC_MODIFIERS[t][0], ETC_MODIFIERS[t][1], -ETC_MODIFIERS[t][0], -ETC_MODIFIERS[t][1]};
+    int error = 0;
+    int candidate[8];
+    for (int i = 0; i < 8 && error < best_error; i++) {
+      const unsigned char *texel = block + texels[i] * 4;
+      int texel_best = std::numeric_limits<int>::max();
+      for (int m = 0; m < 4; m++) {
+        const int dr = texel[0] - clamp_byte(base[0] + modifiers[m]);
+        const int dg = texel[1] - clamp_byte(base[1] + modifiers[m]);
+        const int db = texel[2] - clamp_byte(base[2] + modifiers[m]);
+        const int texel_error = dr * dr + dg * dg + db * db;
+        if (texel_error < texel_best) {
+          texel_best = texel_error;
+          candidate[i] = m;
+        }
+      }
+      error += texel_best;
+    }
+    if (error < best_error) {
+      best_error = error;
+      table = t;
+      std::copy(candidate, candidate + 8, selectors);
+    }
+  }
+  return best_error;
+}
+
+// ETC2 RGB8 using only the ETC1 compatible individual and differential modes. Tries both block splits and both
+// modes and keeps whichever has the lowest error
+inline void encode_etc2_rgb(const unsigned char block[64], unsigned char out[8]) {
+  std::uint64_t best_bits = 0;
+  int best_error = std::numeric_limits<int>::max();
+
+  for (int flip = 0; flip < 2; flip++) {
+    // Texel indices of each half, 2x4 side by side or 4x2 stacked
+    int texels[2][8];
+    int counts[2] = {0, 0};
+    for (int y = 0; y < 4; y++) {
+      for (int x = 0; x < 4; x++) {
+        const int half = flip ? (y >= 2) : (x >= 2);
+        texels[half][counts[half]++] = y * 4 + x;
+      }
+    }
+
+    float average[2][3] = {};
+    for (int half = 0; half < 2; half++) {
+      for (int i = 0; i < 8; i++) {
+        for (int c = 0; c < 3; c++) {
+          average[half][c] += block[texels[half][i] * 4 + c] / 8.0f;
+        }
+      }
+    }
+
+    for (int differential = 0; differential < 2; differential++) {
+      int quantized[2][3];
+      int base[2][3];
+      bool valid = true;
+      for (int half = 0; half < 2; half++) {
+        for (int c = 0; c < 3; c++) {
+          if (differential) {
+            quantized[half][c] = std::min(31, static_cast<int>(average[half][c] * 31.0f / 255.0f + 0.5f));
+            base[half][c] = (quantized[half][c] << 3) | (quantized[half][c] >> 2);
+          }
+          else {
+            quantized[half][c] = std::min(15, static_cast<int>(average[half][c] * 15.0f / 255.0f + 0.5f));
+            base[half][c] = (quantized[half][c] << 4) | quantized[half][c];
+          }
+        }
+      }
+      if (differential) {
+        for (int c = 0; c < 3; c++) {
+          const int delta = quantized[1][c] - quantized[0][c];
+          valid = valid && delta >= -4 && delta <= 3;
+        }
+      }
+      if (!valid) {
+        continue;
+      }
+
+      int tables[2];
+      int selectors[2][8];
+      const int error = fit_etc_subblock(block, texels[0], base[0], tables[0], selectors[0]) +
+                        fit_etc_subblock(block, texels[1], base[1], tables[1], selectors[1]);
+      if (error >= best_error) {
+        continue;
+      }
+      best_error = error;
+
+      std::uint64_t bits = 0;
+      for (int c = 0; c < 3; c++) {
+        const int shift = 59 - c * 8;
+        if (differential) {
+          bits |= static_cast<std::uint64_t>(quantized[0][c]) << shift;
+          bits |= static_cast<std::uint64_t>((quantized[1][c] - quantized[0][c]) & 7) << (shift - 3);
+        }
+        else {
+          bits |= static_cast<std::uint64_t>(quantized[0][c]) << (shift + 1);
+          bits |= static_cast<std::uint64_t>(quantized[1][c]) << (shift - 3);
+        }
+      }
+      bits |= static_cast<std::uint64_t>(tables[0]) << 37;
+      bits |= static_cast<std::uint64_t>(tables[1]) << 34;
+      bits |= static_cast<std::uint64_t>(differential) << 33;
+      bits |= static_cast<std::uint64_t>(flip) << 32;
+
+      // Selectors are stored column major, most significant bits in the upper half. Modifier order on the wire is
+      // +small, +large, -small, -large, which matches the order fit_etc_subblock tries them in
+      for (int half = 0; half < 2; half++) {
+        for (int i = 0; i < 8; i++) {
+          const int texel = texels[half][i];
+          const int index = (texel % 4) * 4 + texel / 4;
+          const int selector = selectors[half][i];
+          bits |= static_cast<std::uint64_t>(selector >> 1) << (16 + index);
+          bits |= static_cast<std::uint64_t>(selector & 1) << index;
+        }
+      }
+      best_bits = bits;
+    }
+  }
+
+  for (int i = 0; i < 8; i++) {
+    out[i] = static_cast<unsigned char>(best_bits >> (56 - i * 8));
+  }
+}
+
+// EAC alpha modifier tables from the ETC2 specification
+const int EAC_MODIFIERS[16][8] = {
+  {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12}, {-2, -5, -8, -13, 1, 4, 7, 12},
+  {-2, -4, -6, -13, 1, 3, 5, 12}, {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+  {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10}, {-2, -6, -8, -10, 1, 5, 7, 9},
+  {-2, -5, -8, -10, 1, 4, 7, 9}, {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+  {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9}, {-4, -6, -8, -9, 3, 5, 7, 8},
+  {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+// EAC alpha: a base value, multiplier and table, with a 3-bit modifier index per texel
+inline void encode_eac_alpha(const unsigned char block[64], unsigned char out[8]) {
+  int low = 255;
+  int high = 0;
+  for (int i = 0; i < 16; i++) {
+    low = std::min(low, static_cast<int>(block[i * 4 + 3]));
+    high = std::max(high, static_cast<int>(block[i * 4 + 3]));
+  }
+
+  int best_error = std::numeric_limits<int>::max();
+  int best_base = high;
+  int best_multiplier = 1;
+  int best_table = 13;
+  int best_selectors[16] = {4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+
+  // A flat block is exactly the base with table 13's zero modifier
+  if (low != high) {
+    for (int table = 0; table < 16; table++) {
+      const int *modifiers = EAC_MODIFIERS[table];
+      for (int multiplier = 1; multiplier < 16; multiplier++) {
+        // Centre the table's range on the block's range
+        const int base = clamp_byte((low - modifiers[3] * multiplier + high - modifiers[7] * multiplier + 1) / 2);
+        int error = 0;
+        int selectors[16];
+        for (int i = 0; i < 16 && error < best_error; i++) {
+          int texel_best = std::numeric_limits<int>::max();
+          for (int m = 0; m < 8; m++) {
+            const int delta = block[i * 4 + 3] - clamp_byte(base + modifiers[m] * multiplier);
+            if (delta * delta < texel_best) {
+              texel_best = delta * delta;
+              selectors[i] = m;
+            }
+          }
+          error += texel_best;
+        }
+        if (error < best_error) {
+          best_error = error;
+          best_base = base;
+          best_multiplier = multiplier;
+          best_table = table;
+          std::copy(selectors, selectors + 16, best_selectors);
+        }
+      }
+    }
+  }
+
+  std::uint64_t bits = static_cast<std::uint64_t>(best_base) << 56;
+  bits |= static_cast<std::uint64_t>(best_multiplier) << 52;
+  bits |= static_cast<std::uint64_t>(best_table) << 48;
+  for (int i = 0; i < 16; i++) {
+    // Column major like the color selectors
+    const int index = (i % 4) * 4 + i / 4;
+    bits |= static_cast<std::uint64_t>(best_selectors[i]) << (45 - index * 3);
+  }
+  for (int i = 0; i < 8; i++) {
+    out[i] = static_cast<unsigned char>(bits >> (56 - i * 8));
+  }
+}
+
+// EAC R11: like EAC alpha, but the base and modifiers are scaled up to 11 bits, and a multiplier of 0 steps by
+// single 11-bit units for smooth gradients. Used twice for RG11, the ETC2 family's counterpart to BC5
+inline void encode_eac_r11(const unsigned char block[64], const int channel, unsigned char out[8]) {
+  int targets[16];
+  int low = 2047;
+  int high = 0;
+  for (int i = 0; i < 16; i++) {
+    targets[i] = (block[i * 4 + channel] * 2047 + 127) / 255;
+    low = std::min(low, targets[i]);
+    high = std::max(high, targets[i]);
+  }
+
+  int best_error = std::numeric_limits<int>::max();
+  int best_base = 0;
+  int best_multiplier = 0;
+  int best_table = 13;
+  int best_selectors[16] = {};
+  for (int table = 0; table < 16 && best_error > 0; table++) {
+    const int *modifiers = EAC_MODIFIERS[table];
+    for (int multiplier = 0; multiplier < 16; multiplier++) {
+      const int step = multiplier == 0 ? 1 : multiplier * 8;
+
+      // Centre the table's range on the block's range, then try the bases either side as well
+      const int centre = ((low - modifiers[3] * step + high - modifiers[7] * step) / 2 - 4) / 8;
+      for (int base = std::max(centre - 1, 0); base <= std::min(centre + 1, 255); base++) {
+        int error = 0;
+        int selectors[16];
+        for (int i = 0; i < 16 && error < best_error; i++) {
+          int texel_best = std::numeric_limits<int>::max();
+          for (int m = 0; m < 8; m++) {
+            const int delta = targets[i] - std::min(std::max(base * 8 + 4 + modifiers[m] * step, 0), 2047);
+            if (delta * delta < texel_best) {
+              texel_best = delta * delta;
+              selectors[i] = m;
+            }
+          }
+          error += texel_best;
+        }
+        if (error < best_error) {
+          best_error = error;
+          best_base = base;
+          best_multiplier = multiplier;
+          best_table = table;
+          std::copy(selectors, selectors + 16, best_selectors);
+        }
+      }
+    }
+  }
+
+  std::uint64_t bits = static_cast<std::uint64_t>(best_base) << 56;
+  bits |= static_cast<std::uint64_t>(best_multiplier) << 52;
+  bits |= static_cast<std::uint64_t>(best_table) << 48;
+  for (int i = 0; i < 16; i++) {
+    const int index = (i % 4) * 4 + i / 4;
+    bits |= static_cast<std::uint64_t>(best_selectors[i]) << (45 - index * 3);
+  }
+  for (int i = 0; i < 8; i++) {
+    out[i] = static_cast<unsigned char>(bits >> (56 - i * 8));
+  }
+}
+
+// EAC RG11: EAC R11 red followed by EAC R11 green, meant for tangent space normal maps
+inline void encode_eac_rg11(const unsigned char block[64], unsigned char out[16]) {
+  encode_eac_r11(block, 0, out);
+  encode_eac_r11(block, 1, out + 8);
+}
+
+// ETC2 RGBA8: EAC alpha followed by ETC2 color
+inline void encode_etc2_rgba(const unsigned char block[64], unsigned char out[16]) {
+  encode_eac_alpha(block, out);
+  encode_etc2_rgb(block, out + 8);
+}
+
+// Compresses a whole RGBA8 image. Texels past the right and bottom edges repeat the last row and column
+inline std::vector<unsigned char> compress_level(const std::uint32_t internal_format, const unsigned char *rgba,
+                                                 const int width, const int height) {
+  const std::size_t block_bytes = ktx_block_bytes(internal_format);
+  std::vector<unsigned char> data(ktx_level_bytes(internal_format, width, height));
+
+  unsigned char *out = data.data();
+  unsigned char block[64];
+  for (int by = 0; by < height; by += 4) {
+    for (int bx = 0; bx < width; bx += 4) {
+      for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+          const int sx = std::min(bx + x, width - 1);
+          const int sy = std::min(by + y, height - 1);
+          std::copy(rgba + (static_cast<std::size_t>(sy) * width + sx) * 4,
+                    rgba + (static_cast<std::size_t>(sy) * width + sx) * 4 + 4, block + (y * 4 + x) * 4);
+        }
+      }
+
+      switch (internal_format) {
+        case KTX_COMPRESSED_RGB_S3TC_DXT1:
+          encode_bc1(block, out);
+          break;
+        case KTX_COMPRESSED_RGBA_S3TC_DXT5:
+          encode_bc3(block, out);
+          break;
+        case KTX_COMPRESSED_RG_RGTC2:
+          encode_bc5(block, out);
+          break;
+        case KTX_COMPRESSED_RG11_EAC:
+          encode_eac_rg11(block, out);
+          break;
+        case KTX_COMPRESSED_RGB8_ETC2:
+          encode_etc2_rgb(block, out);
+          break;
+        case KTX_COMPRESSED_RGBA8_ETC2_EAC:
+          encode_etc2_rgba(block, out);
+          break;
+      }
+      out += block_bytes;
+    }
+  }
+  return data;
+}
+
+// Halves an RGBA8 image with a box filter. Odd edges reuse their last row or column
+inline std::vector<unsigned char> downsample(const std::vector<unsigned char> &rgba, const int width, const int height,
+                                             int &half_width, int &half_height) {
+  half_width = std::max(1, width / 2);
+  half_height = std::max(1, height / 2);
+  std::vector<unsigned char> result(static_cast<std::size_t>(half_width) * half_height * 4);
+  for (int y = 0; y < half_height; y++) {
+    for (int x = 0; x < half_width; x++) {
+      const int x0 = std::min(x * 2, width - 1);
+      const int x1 = std::min(x * 2 + 1, width - 1);
+      const int y0 = std::min(y * 2, height - 1);
+      const int y1 = std::min(y * 2 + 1, height - 1);
+      for (int c = 0; c < 4; c++) {
+        const int sum = rgba[(static_cast<std::size_t>(y0) * width + x0) * 4 + c] +
+                        rgba[(static_cast<std::size_t>(y0) * width + x1) * 4 + c] +
+                        rgba[(static_cast<std::size_t>(y1) * width + x0) * 4 + c] +
+                        rgba[(static_cast<std::size_t>(y1) * width + x1) * 4 + c];
+        result[(static_cast<std::size_t>(y) * half_width + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+      }
+    }
+  }
+  return result;
+}
+
+// Builds the full mip chain of an RGBA8 image down to 1x1 and compresses every level
+inline KtxImage compress_image(const std::uint32_t internal_format, const unsigned char *rgba, const int width,
+                               const int height) {
+  KtxImage image;
+  image.internal_format = internal_format;
+  switch (internal_format) {
+    case KTX_COMPRESSED_RG_RGTC2:
+    case KTX_COMPRESSED_RG11_EAC:
+      image.base_internal_format = KTX_RG;
+      break;
+    case KTX_COMPRESSED_RGBA_S3TC_DXT5:
+    case KTX_COMPRESSED_RGBA8_ETC2_EAC:
+      image.base_internal_format = KTX_RGBA;
+      break;
+    default:
+      image.base_internal_format = KTX_RGB;
+      break;
+  }
+
+  std::vector<unsigned char> level_pixels(rgba, rgba + static_cast<std::size_t>(width) * height * 4);
+  int level_width = width;
+  int level_height = height;
+  for (;;) {
+    KtxLevel level;
+    level.width = level_width;
+    level.height = level_height;
+    level.data = compress_level(internal_format, level_pixels.data(), level_width, level_height);
+    image.levels.push_back(std::move(level));
+
+    if (level_width == 1 && level_height == 1) {
+      break;
+    }
+    level_pixels = downsample(level_pixels, level_width, level_height, level_width, level_height);
+  }
+  return image;
+}
+
+}
+
+#endif /* block_compression_h */
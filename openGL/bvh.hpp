@@ -0,0 +1,452 @@
+//
+//  bvh.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef bvh_h
+#define bvh_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Local Includes
+#include "frustum.hpp"
+#include "glm/glm.hpp"
+
+// Axis aligned box by its corners. Starts out empty, so growing it by anything gives that thing's bounds
+struct Aabb {
+  glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+  Aabb() = default;
+
+  Aabb(const glm::vec3 &low, const glm::vec3 &high)
+  : min(low),
+    max(high) {}
+
+  // Bounds of the local box [low, high] once moved by transform
+  static Aabb transformed(const glm::mat4 &transform, const glm::vec3 &low, const glm::vec3 &high) {
+    const glm::vec3 center = glm::vec3(transform * glm::vec4((low + high) * 0.5f, 1.0f));
+    const glm::mat3 absolute(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])),
+                             glm::abs(glm::vec3(transform[2])));
+    const glm::vec3 extent = absolute * ((high - low) * 0.5f);
+    return Aabb(center - extent, center + extent);
+  }
+
+  void grow(const glm::vec3 &point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+
+  void grow(const Aabb &other) {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+  }
+
+  bool is_empty() const {
+    return min.x > max.x;
+  }
+
+  glm::vec3 get_center() const {
+    return (min + max) * 0.5f;
+  }
+
+  glm::vec3 get_extent() const {
+    return (max - min) * 0.5f;
+  }
+
+  float get_surface_area() const {
+    if (is_empty()) {
+      return 0.0f;
+    }
+    const glm::vec3 size = max - min;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+  }
+
+  bool operator==(const Aabb &other) const {
+    return min == other.min && max == other.max;
+  }
+
+  // Distance along the ray where it enters the box, or a negative value if it misses. inverse_direction is
+  // 1 / direction per component, infinities included
+  float intersect_ray(const glm::vec3 &origin, const glm::vec3 &inverse_direction, const float max_distance) const {
+    const glm::vec3 t0 = (min - origin) * inverse_direction;
+    const glm::vec3 t1 = (max - origin) * inverse_direction;
+    const glm::vec3 near = glm::min(t0, t1);
+    const glm::vec3 far = glm::max(t0, t1);
+    const float enter = std::max(std::max(near.x, near.y), std::max(near.z, 0.0f));
+    const float exit = std::min(std::min(far.x, far.y), std::min(far.z, max_distance));
+    return enter <= exit ? enter : -1.0f;
+  }
+};
+
+// Objects per leaf at most, and buckets the surface area heuristic sorts centroids into
+const std::size_t BVH_MAX_LEAF_SIZE = 4;
+const std::size_t BVH_BIN_COUNT = 16;
+
+// The subtree's objects are always a contiguous run of the object order, so whole subtrees can be taken at once
+struct BvhNode {
+  Aabb bounds;
+  std::uint32_t first = 0;
+  std::uint32_t count = 0;
+
+  // Children are stored next to each other, the left one at this index. Zero for leaves, the root is nobody's
+  // child
+  std::uint32_t left = 0;
+  std::uint32_t parent = 0;
+
+  bool is_leaf() const {
+    return left == 0;
+  }
+};
+
+// Bounding volume hierarchy over object boxes, built top down with a binned surface area heuristic. Objects can
+// move afterwards, refit() then only updates the nodes above them. Trees refit too far from where they were
+// built get slower to search, build() again when objects have moved across the scene
+class Bvh {
+
+public:
+  void build(const std::vector<Aabb> &bounds) {
+    bounds_ = bounds;
+    centers_.resize(bounds_.size());
+    extents_.resize(bounds_.size());
+    for (std::size_t i = 0; i < bounds_.size(); i++) {
+      centers_[i] = bounds_[i].get_center();
+      extents_[i] = bounds_[i].get_extent();
+    }
+    build_tree();
+  }
+
+  // Same, from boxes given by their centers and half extents. Objects are then culled with exactly the numbers
+  // the flat kernels get, where going through the corners and back would round some of them differently
+  void build(const BoxArray &boxes) {
+    bounds_.resize(boxes.size());
+    centers_.resize(boxes.size());
+    extents_.resize(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); i++) {
+      centers_[i] = glm::vec3(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+      extents_[i] = glm::vec3(boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]);
+      bounds_[i] = Aabb(centers_[i] - extents_[i], centers_[i] + extents_[i]);
+    }
+    build_tree();
+  }
+
+  // Records an object's new bounds. Nothing in the tree changes until refit()
+  void update(const std::size_t object, const Aabb &bounds) {
+    bounds_[object] = bounds;
+    centers_[object] = bounds.get_center();
+    extents_[object] = bounds.get_extent();
+    dirty_.push_back(leaf_of_[object]);
+  }
+
+  void update(const std::size_t object, const glm::vec3 &center, const glm::vec3 &extent) {
+    bounds_[object] = Aabb(center - extent, center + extent);
+    centers_[object] = center;
+    extents_[object] = extent;
+    dirty_.push_back(leaf_of_[object]);
+  }
+
+  // Brings the bounds of every node above an updated object up to date. Walking up stops early wherever a
+  // node's bounds come out unchanged
+  void refit() {
+    for (const std::uint32_t leaf : dirty_) {
+      std::uint32_t index = leaf;
+      Aabb bounds = leaf_bounds(nodes_[index]);
+      while (!(bounds == nodes_[index].bounds)) {
+        nodes_[index].bounds = bounds;
+        if (index == 0) {
+          break;
+        }
+        index = nodes_[index].parent;
+        bounds = nodes_[nodes_[index].left].bounds;
+        bounds.grow(nodes_[nodes_[index].left + 1].bounds);
+      }
+    }
+    dirty_.clear();
+  }
+
+  // Appends every object whose box intersects the frustum to visible. Subtrees entirely inside are taken
+  // without testing their objects, and planes a node is entirely inside of are not tested below it
+  template <typename Allocator>
+  void cull(const Frustum &frustum, std::vector<std::uint32_t, Allocator> &visible) const {
+    if (nodes_.empty()) {
+      return;
+    }
+
+    std::pair<std::uint32_t, unsigned int> stack[64];
+    std::size_t depth = 0;
+    stack[depth++] = std::make_pair(0u, FRUSTUM_ALL_PLANES);
+    while (depth > 0) {
+      const BvhNode &node = nodes_[stack[--depth].first];
+      unsigned int plane_mask = stack[depth].second;
+
+      const Frustum::Containment containment = frustum.classify_box(node.bounds.get_center(),
+                                                                   node.bounds.get_extent(), plane_mask);
+      if (containment == Frustum::OUTSIDE) {
+        continue;
+      }
+      if (containment == Frustum::INSIDE) {
+        visible.insert(visible.end(), order_.begin() + node.first, order_.begin() + node.first + node.count);
+      }
+      else if (node.is_leaf()) {
+        for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+          unsigned int object_mask = plane_mask;
+          const std::uint32_t object = order_[i];
+          if (frustum.classify_box(centers_[object], extents_[object], object_mask) != Frustum::OUTSIDE) {
+            visible.push_back(object);
+          }
+        }
+      }
+      else if (depth + 2 <= sizeof(stack) / sizeof(stack[0])) {
+        stack[depth++] = std::make_pair(node.left, plane_mask);
+        stack[depth++] = std::make_pair(node.left + 1, plane_mask);
+      }
+      else {
+        // Deeper than any sane tree, take the subtree whole rather than drop it
+        visible.insert(visible.end(), order_.begin() + node.first, order_.begin() + node.first + node.count);
+      }
+    }
+  }
+
+  // Finds the closest object along a ray. intersect(object, distance) is asked only about objects whose box the
+  // ray enters before the closest hit so far. It returns whether the object itself is hit and sets distance if
+  // that is the case. Distances are in units of the direction's length
+  template <typename Intersect>
+  bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, Intersect intersect, std::uint32_t &object,
+               float &distance) const {
+    distance = std::numeric_limits<float>::max();
+    if (nodes_.empty()) {
+      return false;
+    }
+
+    const glm::vec3 inverse_direction = 1.0f / direction;
+    bool hit = false;
+    std::pair<std::uint32_t, float> stack[64];
+    std::size_t depth = 0;
+    if (nodes_[0].bounds.intersect_ray(origin, inverse_direction, distance) >= 0.0f) {
+      stack[depth++] = std::make_pair(0u, 0.0f);
+    }
+
+    while (depth > 0) {
+      const std::pair<std::uint32_t, float> entry = stack[--depth];
+      if (entry.second > distance) {
+        continue;
+      }
+
+      const BvhNode &node = nodes_[entry.first];
+      if (node.is_leaf()) {
+        hit = raycast_objects(node, origin, inverse_direction, intersect, object, distance) || hit;
+        continue;
+      }
+
+      // The nearer child goes on top so it is searched first, which makes the farther one likelier to be skipped
+      float enter[2];
+      for (std::uint32_t c = 0; c < 2; c++) {
+        enter[c] = nodes_[node.left + c].bounds.intersect_ray(origin, inverse_direction, distance);
+      }
+      const std::uint32_t near = enter[1] >= 0.0f && (enter[0] < 0.0f || enter[1] < enter[0]) ? 1 : 0;
+      const std::uint32_t far = 1 - near;
+      for (const std::uint32_t child : {far, near}) {
+        if (enter[child] < 0.0f) {
+          continue;
+        }
+        if (depth < sizeof(stack) / sizeof(stack[0])) {
+          stack[depth++] = std::make_pair(node.left + child, enter[child]);
+        }
+        else {
+          // Deeper than any sane tree, test the subtree's objects one by one rather than drop them
+          hit = raycast_objects(nodes_[node.left + child], origin, inverse_direction, intersect, object,
+                                distance) || hit;
+        }
+      }
+    }
+    return hit;
+  }
+
+  const std::vector<BvhNode>& get_nodes() const {
+    return nodes_;
+  }
+
+  std::size_t get_depth() const {
+    std::size_t deepest = 0;
+    std::vector<std::size_t> depths(nodes_.size(), 1);
+    for (std::size_t i = 1; i < nodes_.size(); i++) {
+      depths[i] = depths[nodes_[i].parent] + 1;
+      deepest = std::max(deepest, depths[i]);
+    }
+    return deepest;
+  }
+
+private:
+  // Tests every object of a subtree against the ray, keeping the closest hit. Returns whether one was closer
+  template <typename Intersect>
+  bool raycast_objects(const BvhNode &node, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                       Intersect &intersect, std::uint32_t &object, float &distance) const {
+    bool hit = false;
+    for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+      float object_distance = distance;
+      if (bounds_[order_[i]].intersect_ray(origin, inverse_direction, distance) >= 0.0f &&
+          intersect(order_[i], object_distance) && object_distance < distance) {
+        distance = object_distance;
+        object = order_[i];
+        hit = true;
+      }
+    }
+    return hit;
+  }
+
+  void build_tree() {
+    nodes_.clear();
+    order_.resize(bounds_.size());
+    leaf_of_.assign(bounds_.size(), 0);
+    dirty_.clear();
+    if (bounds_.empty()) {
+      return;
+    }
+
+    for (std::size_t i = 0; i < bounds_.size(); i++) {
+      order_[i] = static_cast<std::uint32_t>(i);
+    }
+
+    nodes_.reserve(bounds_.size() * 2 / BVH_MAX_LEAF_SIZE + 1);
+    nodes_.emplace_back();
+    nodes_[0].count = static_cast<std::uint32_t>(bounds_.size());
+
+    // Children are always appended after their parent, so walking the array backwards visits leaves first
+    std::vector<std::uint32_t> pending(1, 0);
+    while (!pending.empty()) {
+      const std::uint32_t index = pending.back();
+      pending.pop_back();
+      if (subdivide(index)) {
+        pending.push_back(nodes_[index].left);
+        pending.push_back(nodes_[index].left + 1);
+      }
+    }
+  }
+
+  Aabb leaf_bounds(const BvhNode &node) const {
+    Aabb bounds;
+    for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+      bounds.grow(bounds_[order_[i]]);
+    }
+    return bounds;
+  }
+
+  // Splits a node in two where the surface area heuristic says it pays off, returns false if it became a leaf
+  bool subdivide(const std::uint32_t index) {
+    BvhNode node = nodes_[index];
+    node.bounds = leaf_bounds(node);
+    nodes_[index].bounds = node.bounds;
+    const auto make_leaf = [this, &node, index]() {
+      for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+        leaf_of_[order_[i]] = index;
+      }
+      return false;
+    };
+    if (node.count <= BVH_MAX_LEAF_SIZE) {
+      return make_leaf();
+    }
+
+    Aabb centroid_bounds;
+    for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+      centroid_bounds.grow(centers_[order_[i]]);
+    }
+
+    // Cost of a split is the area of each side times the objects in it, the axis and bin boundary with the
+    // lowest cost wins
+    float best_cost = std::numeric_limits<float>::max();
+    int best_axis = -1;
+    std::size_t best_split = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      const float low = centroid_bounds.min[axis];
+      const float span = centroid_bounds.max[axis] - low;
+      if (span <= 0.0f) {
+        continue;
+      }
+
+      Aabb bins[BVH_BIN_COUNT];
+      std::size_t counts[BVH_BIN_COUNT] = {};
+      const float scale = BVH_BIN_COUNT / span;
+      for (std::uint32_t i = node.first; i < node.first + node.count; i++) {
+        const std::uint32_t object = order_[i];
+        const std::size_t bin = std::min(BVH_BIN_COUNT - 1,
+                                         static_cast<std::size_t>((centers_[object][axis] - low) * scale));
+        bins[bin].grow(bounds_[object]);
+        ++counts[bin];
+      }
+
+      // Sweep from the right to get the cost of every right side, then from the left to add the left sides
+      float right_area[BVH_BIN_COUNT];
+      std::size_t right_count[BVH_BIN_COUNT];
+      Aabb right;
+      std::size_t right_total = 0;
+      for (std::size_t bin = BVH_BIN_COUNT - 1; bin > 0; bin--) {
+        right.grow(bins[bin]);
+        right_total += counts[bin];
+        right_area[bin] = right.get_surface_area();
+        right_count[bin] = right_total;
+      }
+      Aabb left;
+      std::size_t left_total = 0;
+      for (std::size_t split = 1; split < BVH_BIN_COUNT; split++) {
+        left.grow(bins[split - 1]);
+        left_total += counts[split - 1];
+        const float cost = left.get_surface_area() * left_total + right_area[split] * right_count[split];
+        if (left_total > 0 && right_count[split] > 0 && cost < best_cost) {
+          best_cost = cost;
+          best_axis = axis;
+          best_split = split;
+        }
+      }
+    }
+
+    // Every centroid in the same spot, no split can separate them
+    if (best_axis < 0) {
+      return make_leaf();
+    }
+
+    const float low = centroid_bounds.min[best_axis];
+    const float scale = BVH_BIN_COUNT / (centroid_bounds.max[best_axis] - low);
+    std::uint32_t *begin = order_.data() + node.first;
+    std::uint32_t *middle = std::partition(begin, begin + node.count, [&](const std::uint32_t object) {
+      const std::size_t bin = std::min(BVH_BIN_COUNT - 1,
+                                       static_cast<std::size_t>((centers_[object][best_axis] - low) * scale));
+      return bin < best_split;
+    });
+    const std::uint32_t left_count = static_cast<std::uint32_t>(middle - begin);
+
+    const std::uint32_t left_index = static_cast<std::uint32_t>(nodes_.size());
+    BvhNode left;
+    left.first = node.first;
+    left.count = left_count;
+    left.parent = index;
+    BvhNode right;
+    right.first = node.first + left_count;
+    right.count = node.count - left_count;
+    right.parent = index;
+    nodes_.push_back(left);
+    nodes_.push_back(right);
+    nodes_[index].left = left_index;
+    return true;
+  }
+
+  std::vector<Aabb> bounds_;
+
+  // The same boxes by center and half extent, as frustums test them. Centers also sort objects while building
+  std::vector<glm::vec3> centers_;
+  std::vector<glm::vec3> extents_;
+  std::vector<BvhNode> nodes_;
+  std::vector<std::uint32_t> order_;
+  std::vector<std::uint32_t> leaf_of_;
+  std::vector<std::uint32_t> dirty_;
+};
+
+#endif /* bvh_h */
@@ -0,0 +1,6 @@
+// Camera matrices and position, see CameraBlock in uniform_blocks.hpp. Shared by every program that draws the scene
+layout (std140) uniform CameraBlock {
+  mat4 projection;
+  mat4 view;
+  vec3 viewPos;
+};
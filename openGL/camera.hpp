@@ -13,6 +13,7 @@
 #include <vector>
 
 // Local includes
+#include "frustum.hpp"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -30,6 +31,8 @@ const float PITCH =  0.0f;
 const float SPEED =  2.5f;
 const float SENSITIVITY =  0.1f;
 const float ZOOM =  45.0f;
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 100.0f;
 
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
@@ -69,6 +72,30 @@ public:
     return glm::lookAt(position_, position_ + front_, up_);
   }
 
+  // Perspective projection with the zoom as the vertical field of view
+  glm::mat4 get_projection_matrix(const float aspect_ratio) const {
+    return glm::perspective(glm::radians(zoom_), aspect_ratio, NEAR_PLANE, FAR_PLANE);
+  }
+
+  // World space planes of everything the camera sees
+  Frustum get_frustum(const float aspect_ratio) const {
+    return Frustum::from_matrix(get_projection_matrix(aspect_ratio) *
+                                glm::lookAt(position_, position_ + front_, up_));
+  }
+
+  // World space ray through a point on the screen, given in pixels from the top left. The origin is on the near
+  // plane and the direction has unit length
+  void get_pick_ray(const float x, const float y, const float width, const float height, glm::vec3 &origin,
+                    glm::vec3 &direction) const {
+    const glm::mat4 inverse = glm::inverse(get_projection_matrix(width / height) *
+                                           glm::lookAt(position_, position_ + front_, up_));
+    const glm::vec2 device(2.0f * x / width - 1.0f, 1.0f - 2.0f * y / height);
+    const glm::vec4 near = inverse * glm::vec4(device, -1.0f, 1.0f);
+    const glm::vec4 far = inverse * glm::vec4(device, 1.0f, 1.0f);
+    origin = glm::vec3(near) / near.w;
+    direction = glm::normalize(glm::vec3(far) / far.w - origin);
+  }
+
   float get_zoom() const {
     return zoom_;
   }
@@ -81,6 +108,14 @@ public:
     return front_;
   }
 
+  // Places the camera directly, as scripted camera paths do
+  void set_pose(const glm::vec3 &position, const float yaw, const float pitch) {
+    position_ = position;
+    yaw_ = yaw;
+    pitch_ = pitch;
+    update_camera_vectors();
+  }
+
   // Processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
   void process_keyboard(Camera_Movement direction, const float delta_time) {
     const float velocity = movement_speed_ * delta_time;
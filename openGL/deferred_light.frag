@@ -0,0 +1,49 @@
+#version 330 core
+out vec4 FragColor;
+
+// Lighting pass of deferred shading. Runs once per pixel over the G-buffer left by gbuffer.frag, see gbuffer.hpp,
+// with the same lights and clusters as the forward path in shader.frag
+
+#include "lights.glsl"
+#include "octahedral.glsl"
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gSpecular;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;
+
+void main() {
+  ivec2 pixel = ivec2(gl_FragCoord.xy);
+  float depth = texelFetch(gDepth, pixel, 0).r;
+  if (depth == 1.0) {
+    discard;
+  }
+  // Later forward passes depth test against the scene as if it had been drawn into this framebuffer
+  gl_FragDepth = depth;
+  
+  // Properties, with the position reconstructed from depth
+  vec2 ndc = (vec2(pixel) + 0.5) / vec2(textureSize(gDepth, 0)) * 2.0 - 1.0;
+  vec4 position = inverseViewProjection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+  vec3 fragPos = position.xyz / position.w;
+  vec3 norm = DecodeOctahedral(texelFetch(gNormal, pixel, 0).xy);
+  vec3 viewDir = normalize(viewPos - fragPos);
+  vec4 specular = texelFetch(gSpecular, pixel, 0);
+  Surface surface = Surface(texelFetch(gAlbedo, pixel, 0).rgb, specular.rgb, specular.a * 255.0);
+  
+  // Directional light, the point lights of this pixel's cluster and the flashlight, each of the last two only in
+  // the variants built with them
+  vec3 result = CalcDirLight(dirLight, surface, norm, viewDir);
+#ifdef POINT_LIGHTS
+  uvec2 range = texelFetch(clusterRanges, int(FindCluster(fragPos))).xy;
+  for (uint i = 0u; i < range.y; i++) {
+    int index = int(texelFetch(clusterIndices, int(range.x + i)).x);
+    result += CalcPointLight(FetchPointLight(index), surface, norm, fragPos, viewDir);
+  }
+#endif
+#ifdef SPOT_LIGHT
+  result += CalcSpotLight(spotLight, surface, norm, fragPos, viewDir);
+#endif
+  
+  FragColor = vec4(result, 1.0);
+}
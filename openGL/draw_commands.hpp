@@ -0,0 +1,159 @@
+//
+//  draw_commands.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef draw_commands_h
+#define draw_commands_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Local Includes
+#include "dynamic_ring_buffer.hpp"
+#include "gl_state_cache.hpp"
+#include "instance_buffer.hpp"
+#include "mesh_pool.hpp"
+#include "render_stats.hpp"
+
+// The layout glMultiDrawElementsIndirect reads from the draw indirect buffer
+struct DrawElementsIndirectCommand {
+  std::uint32_t count;
+  std::uint32_t instance_count;
+  std::uint32_t first_index;
+  std::int32_t base_vertex;
+  std::uint32_t base_instance;
+};
+
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "Indirect commands must be tightly packed");
+
+// Draws of meshes in a MeshPool, each an instance range of one array of InstanceData. The commands are built on
+// the CPU, streamed through the frame's DynamicRingBuffer segment, and any consecutive run of them goes out as a
+// single glMultiDrawElementsIndirect call. Contexts older than 4.3 walk the run instead, a draw call per command,
+// with the instance attributes re-pointed at each command's first instance since base instance is missing as well
+class DrawCommandBuffer {
+
+public:
+  // Ctor
+  explicit DrawCommandBuffer(const bool multi_draw)
+  : multi_draw_(multi_draw && is_multi_draw_supported()) {
+  }
+
+  // Whether the context can draw from an indirect buffer with a single call
+  static bool is_multi_draw_supported() {
+    if (glMultiDrawElementsIndirect == nullptr) {
+      return false;
+    }
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    return major > 4 || (major == 4 && minor >= 3);
+  }
+
+  void clear() {
+    commands_.clear();
+    uploaded_ = false;
+  }
+
+  // Queues count instances of a mesh starting at first_instance. Returns the command's index
+  std::uint32_t add(const PooledMesh &mesh, const std::uint32_t first_instance, const std::uint32_t count) {
+    commands_.push_back(DrawElementsIndirectCommand{mesh.index_count, count, mesh.first_index, mesh.base_vertex,
+                                                    first_instance});
+    return static_cast<std::uint32_t>(commands_.size() - 1);
+  }
+
+  // Copies the commands into this frame's segment of the ring. Should the segment be full, the commands are drawn
+  // one call at a time as if multi-draw were missing
+  void upload(DynamicRingBuffer &ring) {
+    if (!multi_draw_ || commands_.empty()) {
+      return;
+    }
+
+    const std::size_t bytes = commands_.size() * sizeof(DrawElementsIndirectCommand);
+    const RingAllocation allocation = ring.allocate(bytes, alignof(DrawElementsIndirectCommand));
+    if (allocation.data != nullptr) {
+      std::memcpy(allocation.data, commands_.data(), bytes);
+      buffer_ = ring.get_id();
+      offset_ = allocation.offset;
+      uploaded_ = true;
+    }
+  }
+
+  // Says where this frame's instances are: instance i of the commands is read from byte offset plus i times the
+  // size of InstanceData in buffer
+  void set_instances(const unsigned int buffer, const std::size_t offset) {
+    instance_buffer_ = buffer;
+    instance_offset_ = offset;
+  }
+
+  // Draws commands first to first + count - 1 from the pool's vertex array, with instances at first_location
+  void draw(const std::uint32_t first, const std::uint32_t count, const MeshPool &pool,
+            const unsigned int first_location) {
+    if (count == 0) {
+      return;
+    }
+    gl_state().bind_vertex_array(pool.get_vertex_array());
+    const GLenum index_type = pool.get_index_type();
+
+    if (uploaded_) {
+      attach(pool, first_location, 0);
+      gl_state().bind_buffer(GL_DRAW_INDIRECT_BUFFER, buffer_);
+      glMultiDrawElementsIndirect(GL_TRIANGLES, index_type,
+                                  (void*)(offset_ + first * sizeof(DrawElementsIndirectCommand)),
+                                  static_cast<GLsizei>(count), 0);
+      ++render_stats().draw_calls;
+      return;
+    }
+
+    for (std::uint32_t i = first; i < first + count; i++) {
+      const DrawElementsIndirectCommand &command = commands_[i];
+      attach(pool, first_location, command.base_instance);
+      glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), index_type,
+                                        (void*)(command.first_index * get_index_size(index_type)),
+                                        static_cast<GLsizei>(command.instance_count), command.base_vertex);
+      ++render_stats().draw_calls;
+    }
+  }
+
+  bool is_multi_draw() const {
+    return multi_draw_;
+  }
+
+  std::size_t size() const {
+    return commands_.size();
+  }
+
+private:
+  // Points the instance attributes at first_instance, unless they already are
+  void attach(const MeshPool &pool, const unsigned int first_location, const std::uint32_t first_instance) {
+    const std::size_t offset = instance_offset_ + first_instance * sizeof(InstanceData);
+    if (attached_buffer_ != instance_buffer_ || attached_offset_ != offset) {
+      attach_instances(pool.get_vertex_array(), instance_buffer_, offset, first_location);
+      attached_buffer_ = instance_buffer_;
+      attached_offset_ = offset;
+    }
+  }
+
+  bool multi_draw_ = false;
+  std::vector<DrawElementsIndirectCommand> commands_;
+
+  // Where this frame's commands were uploaded, if they were
+  bool uploaded_ = false;
+  unsigned int buffer_ = 0;
+  std::size_t offset_ = 0;
+
+  // Where this frame's instances are, and where the attributes of the pool's vertex array point
+  unsigned int instance_buffer_ = 0;
+  std::size_t instance_offset_ = 0;
+  unsigned int attached_buffer_ = UNKNOWN_BINDING;
+  std::size_t attached_offset_ = 0;
+};
+
+#endif /* draw_commands_h */
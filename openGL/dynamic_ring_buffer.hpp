@@ -0,0 +1,206 @@
+//
+//  dynamic_ring_buffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef dynamic_ring_buffer_h
+#define dynamic_ring_buffer_h
+
+// System Includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+
+// Frames the GPU may still be reading while the CPU writes the next one
+const std::size_t RING_SEGMENT_COUNT = 3;
+
+// How long a wait on a segment's fence may take before the ring gives up on it, in nanoseconds
+const std::uint64_t RING_FENCE_TIMEOUT = 1000000000;
+
+// Largest alignment an allocation can ask for, enough for any uniform buffer offset alignment GL reports
+const std::size_t RING_MAX_ALIGNMENT = 256;
+
+// Rounds value up to a multiple of alignment, a power of two
+inline std::size_t align_up(const std::size_t value, const std::size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Part of the ring handed out for this frame. data is null when the frame's segment is full
+struct RingAllocation {
+  unsigned char *data = nullptr;
+  std::size_t offset = 0;
+};
+
+// One buffer that every kind of per-frame data is streamed through: uniform blocks, instances, draw commands.
+// Where the context has glBufferStorage the buffer holds one segment per frame in flight, mapped once for its
+// whole lifetime as persistent and coherent. Each frame writes its own segment through a bump pointer and fences
+// it after its draws, and a segment is only reused once its fence has signaled, so writes never wait on the GPU
+// unless it is more than RING_SEGMENT_COUNT frames behind. Older contexts get a single segment instead, orphaned
+// and mapped again at the start of every frame, which leaves the driver to keep the old storage alive
+class DynamicRingBuffer {
+
+public:
+  // Ctor
+  DynamicRingBuffer(const std::size_t segment_bytes, const bool persistent)
+  : persistent_(persistent && is_persistent_supported()),
+    segment_bytes_(align_up(segment_bytes == 0 ? 1 : segment_bytes, RING_MAX_ALIGNMENT)) {
+    glGenBuffers(1, &id_);
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, id_);
+    if (persistent_) {
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      glBufferStorage(GL_ARRAY_BUFFER, segment_bytes_ * RING_SEGMENT_COUNT, nullptr, flags);
+      mapped_ = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, segment_bytes_ * RING_SEGMENT_COUNT,
+                                                             flags));
+      if (mapped_ == nullptr) {
+        std::cerr << "Failed to map the dynamic ring buffer\n";
+      }
+    }
+    else {
+      glBufferData(GL_ARRAY_BUFFER, segment_bytes_, nullptr, GL_STREAM_DRAW);
+    }
+  }
+
+  // Dtor
+  ~DynamicRingBuffer() {
+    for (GLsync &fence : fences_) {
+      if (fence != nullptr) {
+        glDeleteSync(fence);
+      }
+    }
+    gl_state().forget_buffer(id_);
+    glDeleteBuffers(1, &id_);
+  }
+
+  DynamicRingBuffer(const DynamicRingBuffer&) = delete;
+  DynamicRingBuffer& operator=(const DynamicRingBuffer&) = delete;
+
+  // Whether the context can create immutable storage that stays mapped while the GPU reads it
+  static bool is_persistent_supported() {
+    if (glBufferStorage == nullptr) {
+      return false;
+    }
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    return major > 4 || (major == 4 && minor >= 4);
+  }
+
+  // Moves on to the next segment, waiting for the GPU only if it still has not finished the frame that last used it
+  void begin_frame() {
+    if (persistent_) {
+      segment_ = (segment_ + 1) % RING_SEGMENT_COUNT;
+      wait(fences_[segment_]);
+      head_ = segment_ * segment_bytes_;
+    }
+    else {
+      gl_state().bind_buffer(GL_ARRAY_BUFFER, id_);
+      glBufferData(GL_ARRAY_BUFFER, segment_bytes_, nullptr, GL_STREAM_DRAW);
+      mapped_ = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, segment_bytes_,
+                                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+      head_ = 0;
+    }
+    used_ = 0;
+  }
+
+  // Hands out bytes of this frame's segment at a multiple of alignment, which must be a power of two no larger
+  // than RING_MAX_ALIGNMENT. What is written there may only be read by this frame's draws
+  RingAllocation allocate(const std::size_t bytes, const std::size_t alignment) {
+    const std::size_t segment_start = persistent_ ? segment_ * segment_bytes_ : 0;
+    const std::size_t offset = align_up(head_, alignment);
+    if (mapped_ == nullptr || offset + bytes > segment_start + segment_bytes_) {
+      if (!overflowed_) {
+        std::cerr << "Dynamic ring buffer segment of " << segment_bytes_ << " bytes is too small\n";
+        overflowed_ = true;
+      }
+      return RingAllocation();
+    }
+    head_ = offset + bytes;
+    used_ = head_ - segment_start;
+
+    RingAllocation allocation;
+    allocation.data = mapped_ + offset;
+    allocation.offset = offset;
+    return allocation;
+  }
+
+  // Ends this frame's writes, which must happen before anything draws from the buffer. The persistent mapping is
+  // coherent and stays, the fallback's mapping has to go
+  void finish_writes() {
+    if (!persistent_ && mapped_ != nullptr) {
+      gl_state().bind_buffer(GL_ARRAY_BUFFER, id_);
+      glUnmapBuffer(GL_ARRAY_BUFFER);
+      mapped_ = nullptr;
+    }
+  }
+
+  // Fences the segment once every draw reading it has been issued
+  void end_frame() {
+    if (persistent_) {
+      fences_[segment_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+  }
+
+  unsigned int get_id() const {
+    return id_;
+  }
+
+  bool is_persistent() const {
+    return persistent_;
+  }
+
+  std::size_t get_segment_count() const {
+    return persistent_ ? RING_SEGMENT_COUNT : 1;
+  }
+
+  std::size_t get_segment_bytes() const {
+    return segment_bytes_;
+  }
+
+  // Bytes written to the current segment so far, including alignment padding
+  std::size_t get_used() const {
+    return used_;
+  }
+
+  // Frames that had to wait for the GPU to release their segment
+  std::size_t get_waits() const {
+    return waits_;
+  }
+
+private:
+  void wait(GLsync &fence) {
+    if (fence == nullptr) {
+      return;
+    }
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+      ++waits_;
+      result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, RING_FENCE_TIMEOUT);
+    }
+    if (result == GL_WAIT_FAILED || result == GL_TIMEOUT_EXPIRED) {
+      std::cerr << "Gave up waiting on a dynamic ring buffer segment\n";
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  bool persistent_ = false;
+  std::size_t segment_bytes_ = 0;
+  unsigned int id_ = 0;
+  unsigned char *mapped_ = nullptr;
+  std::array<GLsync, RING_SEGMENT_COUNT> fences_ = {};
+  std::size_t segment_ = 0;
+  std::size_t head_ = 0;
+  std::size_t used_ = 0;
+  std::size_t waits_ = 0;
+  bool overflowed_ = false;
+};
+
+#endif /* dynamic_ring_buffer_h */
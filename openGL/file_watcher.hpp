@@ -0,0 +1,140 @@
+//
+//  file_watcher.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef file_watcher_h
+#define file_watcher_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+
+// Tells which of a set of files were written since the last poll. On Linux inotify queues every write as it
+// happens, and a poll is one read that returns straight away when nothing did. Elsewhere every poll compares
+// modification times. Directories are watched rather than files, since editors often save by writing a new file
+// and renaming it over the old one, which a watch on the old file would never see
+class FileWatcher {
+
+public:
+  // Ctor
+  FileWatcher() {
+#if defined(__linux__)
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  }
+
+  // Dtor
+  ~FileWatcher() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  // Starts watching path. Files already watched are left as they are
+  void watch(const std::string &path) {
+    for (const File &file : files_) {
+      if (file.path == path) {
+        return;
+      }
+    }
+
+    const std::size_t slash = path.find_last_of("/\\");
+    File file;
+    file.path = path;
+    file.name = slash == std::string::npos ? path : path.substr(slash + 1);
+    file.modified = get_modified_time(path);
+#if defined(__linux__)
+    // A directory watched already hands back the descriptor it has
+    if (fd_ >= 0) {
+      const std::string directory = slash == std::string::npos ? std::string(".") : path.substr(0, slash + 1);
+      file.watch = inotify_add_watch(fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    }
+#endif
+    files_.push_back(file);
+  }
+
+  // Appends every watched file written since the last poll to changed, once each
+  void poll(std::vector<std::string> &changed) {
+#if defined(__linux__)
+    if (fd_ >= 0) {
+      alignas(inotify_event) char buffer[4096];
+      ssize_t length = 0;
+      while ((length = read(fd_, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length; ) {
+          const inotify_event *event = reinterpret_cast<const inotify_event*>(buffer + offset);
+          if (event->len > 0) {
+            for (const File &file : files_) {
+              if (file.watch == event->wd && file.name == event->name) {
+                add_once(file.path, changed);
+              }
+            }
+          }
+          offset += sizeof(inotify_event) + event->len;
+        }
+      }
+      return;
+    }
+#endif
+    for (File &file : files_) {
+      const std::int64_t modified = get_modified_time(file.path);
+      if (modified != file.modified) {
+        file.modified = modified;
+        add_once(file.path, changed);
+      }
+    }
+  }
+
+  // Whether changes are reported as they happen instead of by comparing modification times
+  bool is_notified() const {
+    return fd_ >= 0;
+  }
+
+private:
+  struct File {
+    std::string path;
+    std::string name;
+    int watch = -1;
+    std::int64_t modified = 0;
+  };
+
+  static void add_once(const std::string &path, std::vector<std::string> &changed) {
+    if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+      changed.push_back(path);
+    }
+  }
+
+  // Nanoseconds since the epoch, or 0 for a file that cannot be read
+  static std::int64_t get_modified_time(const std::string &path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+      return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<std::int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    return static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+  }
+
+  int fd_ = -1;
+  std::vector<File> files_;
+};
+
+#endif /* file_watcher_h */
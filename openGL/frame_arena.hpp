@@ -0,0 +1,155 @@
+//
+//  frame_arena.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef frame_arena_h
+#define frame_arena_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Alignment of the arena's own block, and of anything asked for without an explicit alignment
+const std::size_t FRAME_ARENA_ALIGNMENT = alignof(std::max_align_t);
+
+// Memory that lives for one frame. Allocations bump a pointer through one block and are never freed one by one,
+// the whole arena is reset at the end of the frame instead. Whatever does not fit is taken from the heap for the
+// rest of the frame, and the next reset grows the block to the largest frame seen so far, so a steady state frame
+// makes no heap allocations at all
+class FrameArena {
+
+public:
+  // Ctor
+  explicit FrameArena(const std::size_t capacity) {
+    grow(capacity);
+  }
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // Hands out bytes at a multiple of alignment, a power of two. They stay valid until the next reset()
+  void* allocate(const std::size_t bytes, const std::size_t alignment = FRAME_ARENA_ALIGNMENT) {
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block_.get());
+    const std::uintptr_t address = (base + head_ + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    const std::size_t end = static_cast<std::size_t>(address - base) + bytes;
+    if (end <= capacity_) {
+      head_ = end;
+      return reinterpret_cast<void*>(address);
+    }
+
+    overflow_bytes_ += bytes + alignment;
+    ++overflow_count_;
+    overflow_.emplace_back(new unsigned char[bytes + alignment]);
+    const std::uintptr_t overflow = reinterpret_cast<std::uintptr_t>(overflow_.back().get());
+    return reinterpret_cast<void*>((overflow + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+  }
+
+  // Releases everything allocated since the last reset. Only call it once nothing allocated is in use any more
+  void reset() {
+    peak_ = std::max(peak_, head_ + overflow_bytes_);
+    if (!overflow_.empty()) {
+      overflow_.clear();
+      grow(peak_ + peak_ / 2);
+    }
+    head_ = 0;
+    overflow_bytes_ = 0;
+  }
+
+  // Bytes handed out since the last reset, alignment padding included
+  std::size_t get_used() const {
+    return head_ + overflow_bytes_;
+  }
+
+  std::size_t get_capacity() const {
+    return capacity_;
+  }
+
+  // Most bytes any frame has used
+  std::size_t get_peak() const {
+    return std::max(peak_, get_used());
+  }
+
+  // Allocations that did not fit and went to the heap, over the arena's lifetime
+  std::size_t get_overflow_count() const {
+    return overflow_count_;
+  }
+
+private:
+  void grow(const std::size_t capacity) {
+    capacity_ = (std::max<std::size_t>(capacity, 1) + FRAME_ARENA_ALIGNMENT - 1) & ~(FRAME_ARENA_ALIGNMENT - 1);
+    block_.reset(new unsigned char[capacity_]);
+  }
+
+  std::unique_ptr<unsigned char[]> block_;
+  std::size_t capacity_ = 0;
+  std::size_t head_ = 0;
+  std::vector<std::unique_ptr<unsigned char[]>> overflow_;
+  std::size_t overflow_bytes_ = 0;
+  std::size_t overflow_count_ = 0;
+  std::size_t peak_ = 0;
+};
+
+// Standard allocator interface over a FrameArena, so containers can keep their storage in it. Deallocation does
+// nothing; the memory comes back when the arena is reset, which means containers must not outlive the frame and
+// should reserve up front, since every reallocation leaves the old storage behind until then
+template <typename T>
+class ArenaAllocator {
+
+public:
+  using value_type = T;
+
+  // Ctor
+  explicit ArenaAllocator(FrameArena &arena) noexcept
+  : arena_(&arena) {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+  : arena_(other.get_arena()) {
+  }
+
+  T* allocate(const std::size_t count) {
+    return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T*, std::size_t) noexcept {
+  }
+
+  FrameArena* get_arena() const {
+    return arena_;
+  }
+
+private:
+  FrameArena *arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+  return a.get_arena() == b.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b) {
+  return a.get_arena() != b.get_arena();
+}
+
+// A vector whose storage lives in a FrameArena, for lists built and thrown away within one frame
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+// An empty FrameVector in arena with room for capacity elements already reserved
+template <typename T>
+FrameVector<T> make_frame_vector(FrameArena &arena, const std::size_t capacity) {
+  FrameVector<T> vector{ArenaAllocator<T>(arena)};
+  vector.reserve(capacity);
+  return vector;
+}
+
+#endif /* frame_arena_h */
@@ -0,0 +1,98 @@
+//
+//  framebuffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef framebuffer_h
+#define framebuffer_h
+
+// System Includes
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+
+// An offscreen render target with an RGBA8 color buffer and a 24 bit depth buffer
+class Framebuffer {
+
+public:
+  // Ctor
+  Framebuffer(const int width, const int height)
+  : width_(width),
+    height_(height) {
+    glGenFramebuffers(1, &id_);
+    gl_state().bind_framebuffer(id_);
+
+    glGenRenderbuffers(1, &color_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_);
+
+    glGenRenderbuffers(1, &depth_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      std::cerr << "ERROR::FRAMEBUFFER:: Framebuffer is not complete\n";
+    }
+    gl_state().bind_framebuffer(0);
+  }
+
+  // Dtor
+  ~Framebuffer() {
+    glDeleteRenderbuffers(1, &depth_);
+    glDeleteRenderbuffers(1, &color_);
+    gl_state().forget_framebuffer(id_);
+    glDeleteFramebuffers(1, &id_);
+  }
+
+  Framebuffer(const Framebuffer&) = delete;
+  Framebuffer& operator=(const Framebuffer&) = delete;
+
+  void bind() const {
+    gl_state().bind_framebuffer(id_);
+    gl_state().viewport(0, 0, width_, height_);
+  }
+
+  unsigned int get_id() const {
+    return id_;
+  }
+
+  // Reads the color buffer back and writes it as a binary PPM, flipped so the image is upright
+  bool save_ppm(const std::string &path) const {
+    std::vector<unsigned char> pixels(static_cast<std::size_t>(width_) * height_ * 4);
+    gl_state().bind_framebuffer(id_);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+      std::cerr << "Could not write " << path << "\n";
+      return false;
+    }
+
+    file << "P6\n" << width_ << " " << height_ << "\n255\n";
+    for (int y = height_ - 1; y >= 0; y--) {
+      for (int x = 0; x < width_; x++) {
+        file.write(reinterpret_cast<const char*>(&pixels[(static_cast<std::size_t>(y) * width_ + x) * 4]), 3);
+      }
+    }
+    return true;
+  }
+
+private:
+  unsigned int id_ = 0;
+  unsigned int color_ = 0;
+  unsigned int depth_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+};
+
+#endif /* framebuffer_h */
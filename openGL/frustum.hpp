@@ -0,0 +1,353 @@
+//
+//  frustum.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef frustum_h
+#define frustum_h
+
+// System Includes
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+// Local Includes
+#include "glm/glm.hpp"
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+// The six planes bounding what a camera sees, normals pointing inwards. A point p is inside a plane when
+// dot(plane.xyz, p) + plane.w >= 0
+struct Frustum {
+  enum {
+    LEFT,
+    RIGHT,
+    BOTTOM,
+    TOP,
+    NEAR,
+    FAR,
+    PLANE_COUNT
+  };
+
+  glm::vec4 planes[PLANE_COUNT];
+
+  // Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix".
+  // Planes come out in the space the matrix transforms from, so projection * view gives world space planes
+  static Frustum from_matrix(const glm::mat4 &matrix) {
+    const glm::vec4 row_x(matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]);
+    const glm::vec4 row_y(matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]);
+    const glm::vec4 row_z(matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]);
+    const glm::vec4 row_w(matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]);
+
+    Frustum frustum;
+    frustum.planes[LEFT] = row_w + row_x;
+    frustum.planes[RIGHT] = row_w - row_x;
+    frustum.planes[BOTTOM] = row_w + row_y;
+    frustum.planes[TOP] = row_w - row_y;
+    frustum.planes[NEAR] = row_w + row_z;
+    frustum.planes[FAR] = row_w - row_z;
+
+    // Normalized so plane distances are real distances, which sphere tests need
+    for (glm::vec4 &plane : frustum.planes) {
+      plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+  }
+
+  // The tests below add up in the same order as the SIMD kernels, so both always agree
+  bool intersects_sphere(const glm::vec3 &center, const float radius) const {
+    for (const glm::vec4 &plane : planes) {
+      const float distance = center.x * plane.x + center.y * plane.y + center.z * plane.z;
+      if (distance + radius < -plane.w) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Conservative, a box across the corner outside two planes still counts as visible
+  bool intersects_box(const glm::vec3 &center, const glm::vec3 &extent) const {
+    for (const glm::vec4 &plane : planes) {
+      const float distance = center.x * plane.x + center.y * plane.y + center.z * plane.z;
+      const float reach = extent.x * std::abs(plane.x) + extent.y * std::abs(plane.y) + extent.z * std::abs(plane.z);
+      if (distance + reach < -plane.w) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  enum Containment {
+    OUTSIDE,
+    INTERSECTING,
+    INSIDE
+  };
+
+  // Like intersects_box(), but also tells boxes entirely inside apart. Only the planes set in plane_mask are
+  // tested, and the planes the box is entirely inside of are cleared from it. Everything within a box that
+  // is inside a plane is inside it too, so hierarchies pass the mask on to skip those planes further down
+  Containment classify_box(const glm::vec3 &center, const glm::vec3 &extent, unsigned int &plane_mask) const {
+    for (int p = 0; p < PLANE_COUNT; p++) {
+      if ((plane_mask & (1u << p)) == 0) {
+        continue;
+      }
+      const glm::vec4 &plane = planes[p];
+      const float distance = center.x * plane.x + center.y * plane.y + center.z * plane.z;
+      const float reach = extent.x * std::abs(plane.x) + extent.y * std::abs(plane.y) + extent.z * std::abs(plane.z);
+      if (distance + reach < -plane.w) {
+        return OUTSIDE;
+      }
+      if (distance - reach >= -plane.w) {
+        plane_mask &= ~(1u << p);
+      }
+    }
+    return plane_mask == 0 ? INSIDE : INTERSECTING;
+  }
+};
+
+const unsigned int FRUSTUM_ALL_PLANES = (1u << Frustum::PLANE_COUNT) - 1u;
+
+// Axis aligned boxes as centers and half extents. Each component has an array of its own, so one load brings in
+// the same component of four or eight boxes
+struct BoxArray {
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> center_z;
+  std::vector<float> extent_x;
+  std::vector<float> extent_y;
+  std::vector<float> extent_z;
+
+  std::size_t size() const {
+    return center_x.size();
+  }
+
+  void clear() {
+    for (std::vector<float> *component : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z}) {
+      component->clear();
+    }
+  }
+
+  void reserve(const std::size_t count) {
+    for (std::vector<float> *component : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z}) {
+      component->reserve(count);
+    }
+  }
+
+  void push_back(const glm::vec3 &center, const glm::vec3 &extent) {
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    center_z.push_back(center.z);
+    extent_x.push_back(extent.x);
+    extent_y.push_back(extent.y);
+    extent_z.push_back(extent.z);
+  }
+
+  // Bounds of a local box [min, max] once moved by transform
+  void push_back(const glm::mat4 &transform, const glm::vec3 &min, const glm::vec3 &max) {
+    const glm::vec3 center = glm::vec3(transform * glm::vec4((min + max) * 0.5f, 1.0f));
+    const glm::mat3 absolute(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])),
+                             glm::abs(glm::vec3(transform[2])));
+    push_back(center, absolute * ((max - min) * 0.5f));
+  }
+};
+
+// Bounding spheres, laid out like BoxArray
+struct SphereArray {
+  std::vector<float> center_x;
+  std::vector<float> center_y;
+  std::vector<float> center_z;
+  std::vector<float> radius;
+
+  std::size_t size() const {
+    return center_x.size();
+  }
+
+  void push_back(const glm::vec3 &center, const float sphere_radius) {
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    center_z.push_back(center.z);
+    radius.push_back(sphere_radius);
+  }
+};
+
+namespace culling {
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+// Four lanes of SSE
+struct Float4 {
+  typedef __m128 Type;
+  static const std::size_t WIDTH = 4;
+
+  static Type load(const float *p) { return _mm_loadu_ps(p); }
+  static Type splat(const float value) { return _mm_set1_ps(value); }
+  static Type add(const Type a, const Type b) { return _mm_add_ps(a, b); }
+  static Type mul(const Type a, const Type b) { return _mm_mul_ps(a, b); }
+  static Type less(const Type a, const Type b) { return _mm_cmplt_ps(a, b); }
+  static Type either(const Type a, const Type b) { return _mm_or_ps(a, b); }
+  static Type zero() { return _mm_setzero_ps(); }
+  static unsigned int mask(const Type a) { return static_cast<unsigned int>(_mm_movemask_ps(a)); }
+};
+#endif
+
+#if defined(__AVX__)
+// Eight lanes of AVX
+struct Float8 {
+  typedef __m256 Type;
+  static const std::size_t WIDTH = 8;
+
+  static Type load(const float *p) { return _mm256_loadu_ps(p); }
+  static Type splat(const float value) { return _mm256_set1_ps(value); }
+  static Type add(const Type a, const Type b) { return _mm256_add_ps(a, b); }
+  static Type mul(const Type a, const Type b) { return _mm256_mul_ps(a, b); }
+  static Type less(const Type a, const Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static Type either(const Type a, const Type b) { return _mm256_or_ps(a, b); }
+  static Type zero() { return _mm256_setzero_ps(); }
+  static unsigned int mask(const Type a) { return static_cast<unsigned int>(_mm256_movemask_ps(a)); }
+};
+#endif
+
+// Appends first + lane for every lane not set in outside
+inline std::size_t append_visible(unsigned int outside, const std::size_t width, const std::size_t first,
+                                  std::uint32_t *visible, std::size_t count) {
+  unsigned int inside = ~outside & ((1u << width) - 1u);
+  while (inside != 0) {
+    visible[count++] = static_cast<std::uint32_t>(first + static_cast<std::size_t>(__builtin_ctz(inside)));
+    inside &= inside - 1u;
+  }
+  return count;
+}
+
+// Tests the boxes in [first, last) WIDTH at a time against every plane. A partial group at the end is left over
+template <typename W>
+std::size_t cull_boxes(const Frustum &frustum, const BoxArray &boxes, const std::size_t first,
+                       const std::size_t last, std::uint32_t *visible, std::size_t count) {
+  typename W::Type plane_x[Frustum::PLANE_COUNT], plane_y[Frustum::PLANE_COUNT], plane_z[Frustum::PLANE_COUNT];
+  typename W::Type abs_x[Frustum::PLANE_COUNT], abs_y[Frustum::PLANE_COUNT], abs_z[Frustum::PLANE_COUNT];
+  typename W::Type neg_w[Frustum::PLANE_COUNT];
+  for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+    const glm::vec4 &plane = frustum.planes[p];
+    plane_x[p] = W::splat(plane.x);
+    plane_y[p] = W::splat(plane.y);
+    plane_z[p] = W::splat(plane.z);
+    abs_x[p] = W::splat(std::abs(plane.x));
+    abs_y[p] = W::splat(std::abs(plane.y));
+    abs_z[p] = W::splat(std::abs(plane.z));
+    neg_w[p] = W::splat(-plane.w);
+  }
+
+  for (std::size_t i = first; i + W::WIDTH <= last; i += W::WIDTH) {
+    const typename W::Type cx = W::load(&boxes.center_x[i]);
+    const typename W::Type cy = W::load(&boxes.center_y[i]);
+    const typename W::Type cz = W::load(&boxes.center_z[i]);
+    const typename W::Type ex = W::load(&boxes.extent_x[i]);
+    const typename W::Type ey = W::load(&boxes.extent_y[i]);
+    const typename W::Type ez = W::load(&boxes.extent_z[i]);
+
+    // Outside a plane when the center is further behind it than the box reaches towards it
+    typename W::Type outside = W::zero();
+    for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+      const typename W::Type distance = W::add(W::add(W::mul(cx, plane_x[p]), W::mul(cy, plane_y[p])),
+                                               W::mul(cz, plane_z[p]));
+      const typename W::Type reach = W::add(W::add(W::mul(ex, abs_x[p]), W::mul(ey, abs_y[p])),
+                                            W::mul(ez, abs_z[p]));
+      outside = W::either(outside, W::less(W::add(distance, reach), neg_w[p]));
+    }
+    count = append_visible(W::mask(outside), W::WIDTH, i, visible, count);
+  }
+  return count;
+}
+
+template <typename W>
+std::size_t cull_spheres(const Frustum &frustum, const SphereArray &spheres, const std::size_t first,
+                         const std::size_t last, std::uint32_t *visible, std::size_t count) {
+  typename W::Type plane_x[Frustum::PLANE_COUNT], plane_y[Frustum::PLANE_COUNT], plane_z[Frustum::PLANE_COUNT];
+  typename W::Type neg_w[Frustum::PLANE_COUNT];
+  for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+    plane_x[p] = W::splat(frustum.planes[p].x);
+    plane_y[p] = W::splat(frustum.planes[p].y);
+    plane_z[p] = W::splat(frustum.planes[p].z);
+    neg_w[p] = W::splat(-frustum.planes[p].w);
+  }
+
+  for (std::size_t i = first; i + W::WIDTH <= last; i += W::WIDTH) {
+    const typename W::Type cx = W::load(&spheres.center_x[i]);
+    const typename W::Type cy = W::load(&spheres.center_y[i]);
+    const typename W::Type cz = W::load(&spheres.center_z[i]);
+    const typename W::Type r = W::load(&spheres.radius[i]);
+
+    typename W::Type outside = W::zero();
+    for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+      const typename W::Type distance = W::add(W::add(W::mul(cx, plane_x[p]), W::mul(cy, plane_y[p])),
+                                               W::mul(cz, plane_z[p]));
+      outside = W::either(outside, W::less(W::add(distance, r), neg_w[p]));
+    }
+    count = append_visible(W::mask(outside), W::WIDTH, i, visible, count);
+  }
+  return count;
+}
+
+}
+
+// Writes the index of every box that intersects the frustum into visible, which needs room for all of them.
+// Returns how many were written. One box at a time, for reference and for the leftovers of the wide paths
+inline std::size_t cull_boxes_scalar(const Frustum &frustum, const BoxArray &boxes, std::uint32_t *visible,
+                                     const std::size_t first = 0, std::size_t count = 0) {
+  for (std::size_t i = first; i < boxes.size(); i++) {
+    const glm::vec3 center(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+    const glm::vec3 extent(boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]);
+    if (frustum.intersects_box(center, extent)) {
+      visible[count++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return count;
+}
+
+inline std::size_t cull_spheres_scalar(const Frustum &frustum, const SphereArray &spheres, std::uint32_t *visible,
+                                       const std::size_t first = 0, std::size_t count = 0) {
+  for (std::size_t i = first; i < spheres.size(); i++) {
+    const glm::vec3 center(spheres.center_x[i], spheres.center_y[i], spheres.center_z[i]);
+    if (frustum.intersects_sphere(center, spheres.radius[i])) {
+      visible[count++] = static_cast<std::uint32_t>(i);
+    }
+  }
+  return count;
+}
+
+// Same as cull_boxes_scalar(), eight boxes at a time with AVX or four with SSE when compiled in
+inline std::size_t cull_boxes(const Frustum &frustum, const BoxArray &boxes, std::uint32_t *visible) {
+  std::size_t count = 0;
+  std::size_t done = 0;
+#if defined(__AVX__)
+  count = culling::cull_boxes<culling::Float8>(frustum, boxes, 0, boxes.size(), visible, count);
+  done = boxes.size() / culling::Float8::WIDTH * culling::Float8::WIDTH;
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+  count = culling::cull_boxes<culling::Float4>(frustum, boxes, 0, boxes.size(), visible, count);
+  done = boxes.size() / culling::Float4::WIDTH * culling::Float4::WIDTH;
+#endif
+  return cull_boxes_scalar(frustum, boxes, visible, done, count);
+}
+
+inline std::size_t cull_spheres(const Frustum &frustum, const SphereArray &spheres, std::uint32_t *visible) {
+  std::size_t count = 0;
+  std::size_t done = 0;
+#if defined(__AVX__)
+  count = culling::cull_spheres<culling::Float8>(frustum, spheres, 0, spheres.size(), visible, count);
+  done = spheres.size() / culling::Float8::WIDTH * culling::Float8::WIDTH;
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+  count = culling::cull_spheres<culling::Float4>(frustum, spheres, 0, spheres.size(), visible, count);
+  done = spheres.size() / culling::Float4::WIDTH * culling::Float4::WIDTH;
+#endif
+  return cull_spheres_scalar(frustum, spheres, visible, done, count);
+}
+
+#endif /* frustum_h */
@@ -0,0 +1,30 @@
+#version 330 core
+#include "octahedral.glsl"
+
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec2 gNormal;
+layout (location = 2) out vec4 gSpecular;
+
+struct Material {
+  sampler2D diffuse;
+  sampler2D specular;
+  float shininess;
+};
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+
+uniform Material material;
+
+// Geometry pass of deferred shading, fills the G-buffer described in gbuffer.hpp. No lighting happens here
+void main() {
+  gAlbedo = vec4(texture(material.diffuse, TexCoords).rgb, 1.0);
+  gNormal = EncodeOctahedral(normalize(Normal));
+#ifdef SPECULAR_MAP
+  gSpecular = vec4(texture(material.specular, TexCoords).rgb, material.shininess / 255.0);
+#else
+  // Materials without a specular map are matte
+  gSpecular = vec4(0.0, 0.0, 0.0, material.shininess / 255.0);
+#endif
+}
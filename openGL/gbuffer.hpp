@@ -0,0 +1,122 @@
+//
+//  gbuffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef gbuffer_h
+#define gbuffer_h
+
+// System Includes
+#include <cstddef>
+#include <iostream>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+
+// Texture units the lighting pass reads the G-buffer from, after the material maps and the light buffers
+const unsigned int GBUFFER_ALBEDO_TEXTURE_UNIT = 5;
+const unsigned int GBUFFER_NORMAL_TEXTURE_UNIT = 6;
+const unsigned int GBUFFER_SPECULAR_TEXTURE_UNIT = 7;
+const unsigned int GBUFFER_DEPTH_TEXTURE_UNIT = 8;
+
+// What the geometry pass of deferred shading leaves behind for the lighting pass, 16 bytes a pixel:
+//   albedo    RGBA8        diffuse map color
+//   normal    RG16_SNORM   world space normal, octahedral encoded
+//   specular  RGBA8        specular map color, and shininess / 255 in alpha
+//   depth     DEPTH24      positions are reconstructed from it with the inverse view projection
+class GBuffer {
+
+public:
+  // Ctor
+  GBuffer(const int width, const int height) {
+    glGenFramebuffers(1, &id_);
+    glGenTextures(1, &albedo_);
+    glGenTextures(1, &normal_);
+    glGenTextures(1, &specular_);
+    glGenTextures(1, &depth_);
+    resize(width, height);
+  }
+
+  // Dtor
+  ~GBuffer() {
+    for (const unsigned int texture : {albedo_, normal_, specular_, depth_}) {
+      gl_state().forget_texture(texture);
+    }
+    gl_state().forget_framebuffer(id_);
+    glDeleteTextures(1, &depth_);
+    glDeleteTextures(1, &specular_);
+    glDeleteTextures(1, &normal_);
+    glDeleteTextures(1, &albedo_);
+    glDeleteFramebuffers(1, &id_);
+  }
+
+  GBuffer(const GBuffer&) = delete;
+  GBuffer& operator=(const GBuffer&) = delete;
+
+  // Reallocates every target at a new size, does nothing if the size is unchanged
+  void resize(const int width, const int height) {
+    if (width == width_ && height == height_) {
+      return;
+    }
+    width_ = width;
+    height_ = height;
+
+    allocate(albedo_, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+    allocate(normal_, GL_RG16_SNORM, GL_RG, GL_SHORT);
+    allocate(specular_, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+    allocate(depth_, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+
+    gl_state().bind_framebuffer(id_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo_, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normal_, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, specular_, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_, 0);
+    const GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+    glDrawBuffers(3, attachments);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+      std::cerr << "ERROR::FRAMEBUFFER:: G-buffer is not complete\n";
+    }
+  }
+
+  // Geometry pass target
+  void bind() const {
+    gl_state().bind_framebuffer(id_);
+    gl_state().viewport(0, 0, width_, height_);
+  }
+
+  // Lighting pass inputs
+  void bind_textures() const {
+    const unsigned int textures[] = {albedo_, normal_, specular_, depth_};
+    const unsigned int units[] = {GBUFFER_ALBEDO_TEXTURE_UNIT, GBUFFER_NORMAL_TEXTURE_UNIT,
+                                  GBUFFER_SPECULAR_TEXTURE_UNIT, GBUFFER_DEPTH_TEXTURE_UNIT};
+    for (int i = 0; i < 4; i++) {
+      gl_state().bind_texture(units[i], GL_TEXTURE_2D, textures[i]);
+    }
+  }
+
+  std::size_t get_bytes() const {
+    return static_cast<std::size_t>(width_) * height_ * 16;
+  }
+
+private:
+  void allocate(const unsigned int texture, const GLenum internal_format, const GLenum format, const GLenum type) {
+    gl_state().bind_texture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width_, height_, 0, format, type, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  }
+
+  unsigned int id_ = 0;
+  unsigned int albedo_ = 0;
+  unsigned int normal_ = 0;
+  unsigned int specular_ = 0;
+  unsigned int depth_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+};
+
+#endif /* gbuffer_h */
@@ -0,0 +1,197 @@
+//
+//  gl_loader.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef gl_loader_h
+#define gl_loader_h
+
+// Signature shared by glfwGetProcAddress and eglGetProcAddress once cast
+using GLProcLoader = void *(*)(const char *name);
+
+#if defined(__APPLE__)
+
+// macOS links every core entry point directly, so there is nothing to load
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+
+// Nor is there anything past 4.1, so the optional functions of newer versions are never available
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (*PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect,
+                                                   GLsizei drawcount, GLsizei stride);
+typedef void (*PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+const PFNGLMULTIDRAWELEMENTSINDIRECTPROC glMultiDrawElementsIndirect = nullptr;
+const PFNGLBUFFERSTORAGEPROC glBufferStorage = nullptr;
+
+// Nor does it offer KHR_parallel_shader_compile
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (*PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+const PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = nullptr;
+
+inline bool load_gl_functions(GLProcLoader) {
+  return true;
+}
+
+#else
+
+// Elsewhere the core profile headers only declare function pointer types. Every GL function the renderer
+// calls is listed here and resolved at runtime from whichever context was created.
+// Define GL_LOADER_IMPLEMENTATION in exactly one translation unit before including this file
+#include <GL/glcorearb.h>
+
+#include <iostream>
+
+#define OPENGL_FUNCTIONS(X) \
+  X(PFNGLACTIVETEXTUREPROC, glActiveTexture) \
+  X(PFNGLATTACHSHADERPROC, glAttachShader) \
+  X(PFNGLBEGINQUERYPROC, glBeginQuery) \
+  X(PFNGLBINDBUFFERPROC, glBindBuffer) \
+  X(PFNGLBINDBUFFERBASEPROC, glBindBufferBase) \
+  X(PFNGLBINDBUFFERRANGEPROC, glBindBufferRange) \
+  X(PFNGLBINDFRAMEBUFFERPROC, glBindFramebuffer) \
+  X(PFNGLBINDRENDERBUFFERPROC, glBindRenderbuffer) \
+  X(PFNGLBINDTEXTUREPROC, glBindTexture) \
+  X(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray) \
+  X(PFNGLBLENDFUNCPROC, glBlendFunc) \
+  X(PFNGLBUFFERDATAPROC, glBufferData) \
+  X(PFNGLBUFFERSUBDATAPROC, glBufferSubData) \
+  X(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus) \
+  X(PFNGLCLEARPROC, glClear) \
+  X(PFNGLCLEARCOLORPROC, glClearColor) \
+  X(PFNGLCLIENTWAITSYNCPROC, glClientWaitSync) \
+  X(PFNGLCOMPILESHADERPROC, glCompileShader) \
+  X(PFNGLCOMPRESSEDTEXIMAGE2DPROC, glCompressedTexImage2D) \
+  X(PFNGLCREATEPROGRAMPROC, glCreateProgram) \
+  X(PFNGLCREATESHADERPROC, glCreateShader) \
+  X(PFNGLDELETEBUFFERSPROC, glDeleteBuffers) \
+  X(PFNGLDELETEFRAMEBUFFERSPROC, glDeleteFramebuffers) \
+  X(PFNGLDELETEPROGRAMPROC, glDeleteProgram) \
+  X(PFNGLDELETEQUERIESPROC, glDeleteQueries) \
+  X(PFNGLDELETERENDERBUFFERSPROC, glDeleteRenderbuffers) \
+  X(PFNGLDELETESHADERPROC, glDeleteShader) \
+  X(PFNGLDELETESYNCPROC, glDeleteSync) \
+  X(PFNGLDELETETEXTURESPROC, glDeleteTextures) \
+  X(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays) \
+  X(PFNGLDEPTHFUNCPROC, glDepthFunc) \
+  X(PFNGLDEPTHMASKPROC, glDepthMask) \
+  X(PFNGLDISABLEPROC, glDisable) \
+  X(PFNGLDRAWARRAYSPROC, glDrawArrays) \
+  X(PFNGLDRAWARRAYSINSTANCEDPROC, glDrawArraysInstanced) \
+  X(PFNGLDRAWBUFFERSPROC, glDrawBuffers) \
+  X(PFNGLDRAWELEMENTSINSTANCEDPROC, glDrawElementsInstanced) \
+  X(PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC, glDrawElementsInstancedBaseVertex) \
+  X(PFNGLENABLEPROC, glEnable) \
+  X(PFNGLENABLEVERTEXATTRIBARRAYPROC, glEnableVertexAttribArray) \
+  X(PFNGLENDQUERYPROC, glEndQuery) \
+  X(PFNGLFENCESYNCPROC, glFenceSync) \
+  X(PFNGLFINISHPROC, glFinish) \
+  X(PFNGLFLUSHPROC, glFlush) \
+  X(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer) \
+  X(PFNGLFRAMEBUFFERTEXTURE2DPROC, glFramebufferTexture2D) \
+  X(PFNGLGENBUFFERSPROC, glGenBuffers) \
+  X(PFNGLGENERATEMIPMAPPROC, glGenerateMipmap) \
+  X(PFNGLGENFRAMEBUFFERSPROC, glGenFramebuffers) \
+  X(PFNGLGENQUERIESPROC, glGenQueries) \
+  X(PFNGLGENRENDERBUFFERSPROC, glGenRenderbuffers) \
+  X(PFNGLGENTEXTURESPROC, glGenTextures) \
+  X(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays) \
+  X(PFNGLGETACTIVEUNIFORMPROC, glGetActiveUniform) \
+  X(PFNGLGETERRORPROC, glGetError) \
+  X(PFNGLGETINTEGER64VPROC, glGetInteger64v) \
+  X(PFNGLGETINTEGERVPROC, glGetIntegerv) \
+  X(PFNGLGETPROGRAMINFOLOGPROC, glGetProgramInfoLog) \
+  X(PFNGLGETPROGRAMIVPROC, glGetProgramiv) \
+  X(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv) \
+  X(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v) \
+  X(PFNGLGETSHADERINFOLOGPROC, glGetShaderInfoLog) \
+  X(PFNGLGETSHADERIVPROC, glGetShaderiv) \
+  X(PFNGLGETSTRINGPROC, glGetString) \
+  X(PFNGLGETSTRINGIPROC, glGetStringi) \
+  X(PFNGLGETUNIFORMBLOCKINDEXPROC, glGetUniformBlockIndex) \
+  X(PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation) \
+  X(PFNGLLINKPROGRAMPROC, glLinkProgram) \
+  X(PFNGLMAPBUFFERRANGEPROC, glMapBufferRange) \
+  X(PFNGLPIXELSTOREIPROC, glPixelStorei) \
+  X(PFNGLQUERYCOUNTERPROC, glQueryCounter) \
+  X(PFNGLREADPIXELSPROC, glReadPixels) \
+  X(PFNGLRENDERBUFFERSTORAGEPROC, glRenderbufferStorage) \
+  X(PFNGLSHADERSOURCEPROC, glShaderSource) \
+  X(PFNGLTEXBUFFERPROC, glTexBuffer) \
+  X(PFNGLTEXIMAGE2DPROC, glTexImage2D) \
+  X(PFNGLTEXPARAMETERIPROC, glTexParameteri) \
+  X(PFNGLUNIFORM1FPROC, glUniform1f) \
+  X(PFNGLUNIFORM1IPROC, glUniform1i) \
+  X(PFNGLUNIFORM2FPROC, glUniform2f) \
+  X(PFNGLUNIFORM2FVPROC, glUniform2fv) \
+  X(PFNGLUNIFORM3FPROC, glUniform3f) \
+  X(PFNGLUNIFORM3FVPROC, glUniform3fv) \
+  X(PFNGLUNIFORM4FPROC, glUniform4f) \
+  X(PFNGLUNIFORM4FVPROC, glUniform4fv) \
+  X(PFNGLUNIFORMBLOCKBINDINGPROC, glUniformBlockBinding) \
+  X(PFNGLUNIFORMMATRIX2FVPROC, glUniformMatrix2fv) \
+  X(PFNGLUNIFORMMATRIX3FVPROC, glUniformMatrix3fv) \
+  X(PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv) \
+  X(PFNGLUNMAPBUFFERPROC, glUnmapBuffer) \
+  X(PFNGLUSEPROGRAMPROC, glUseProgram) \
+  X(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor) \
+  X(PFNGLVERTEXATTRIBPOINTERPROC, glVertexAttribPointer) \
+  X(PFNGLVIEWPORTPROC, glViewport)
+
+// Functions from versions past 3.3, and from extensions, that the renderer can do without. They are loaded when
+// the driver exports them and left null otherwise, so check for null and for the context version or extension
+// before calling them
+#define OPENGL_OPTIONAL_FUNCTIONS(X) \
+  X(PFNGLBUFFERSTORAGEPROC, glBufferStorage) \
+  X(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary) \
+  X(PFNGLMAXSHADERCOMPILERTHREADSKHRPROC, glMaxShaderCompilerThreadsKHR) \
+  X(PFNGLMULTIDRAWELEMENTSINDIRECTPROC, glMultiDrawElementsIndirect) \
+  X(PFNGLPROGRAMBINARYPROC, glProgramBinary) \
+  X(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri)
+
+#define OPENGL_DECLARE_FUNCTION(type, name) extern type name;
+OPENGL_FUNCTIONS(OPENGL_DECLARE_FUNCTION)
+OPENGL_OPTIONAL_FUNCTIONS(OPENGL_DECLARE_FUNCTION)
+#undef OPENGL_DECLARE_FUNCTION
+
+#ifdef GL_LOADER_IMPLEMENTATION
+#define OPENGL_DEFINE_FUNCTION(type, name) type name = nullptr;
+OPENGL_FUNCTIONS(OPENGL_DEFINE_FUNCTION)
+OPENGL_OPTIONAL_FUNCTIONS(OPENGL_DEFINE_FUNCTION)
+#undef OPENGL_DEFINE_FUNCTION
+#endif
+
+// Resolves every listed function from the current context. Returns false if any of them is missing
+inline bool load_gl_functions(GLProcLoader loader) {
+  bool complete = true;
+
+#define OPENGL_LOAD_FUNCTION(type, name) \
+  name = reinterpret_cast<type>(loader(#name)); \
+  if (name == nullptr) { \
+    std::cerr << "Failed to load OpenGL function " << #name << "\n"; \
+    complete = false; \
+  }
+  OPENGL_FUNCTIONS(OPENGL_LOAD_FUNCTION)
+#undef OPENGL_LOAD_FUNCTION
+
+#define OPENGL_LOAD_OPTIONAL_FUNCTION(type, name) \
+  name = reinterpret_cast<type>(loader(#name));
+  OPENGL_OPTIONAL_FUNCTIONS(OPENGL_LOAD_OPTIONAL_FUNCTION)
+#undef OPENGL_LOAD_OPTIONAL_FUNCTION
+
+  return complete;
+}
+
+#endif
+
+#endif /* gl_loader_h */
@@ -0,0 +1,335 @@
+//
+//  gl_state_cache.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef gl_state_cache_h
+#define gl_state_cache_h
+
+// System Includes
+#include <array>
+#include <cstddef>
+
+// Local Includes
+#include "render_stats.hpp"
+
+// Texture units the cache shadows, enough for every unit the shaders sample from
+const unsigned int STATE_CACHE_TEXTURE_UNITS = 16;
+
+// Indexed uniform buffer binding points the cache shadows
+const unsigned int STATE_CACHE_UNIFORM_BINDINGS = 16;
+
+// No GL object has this name, so it never matches a real binding
+const unsigned int UNKNOWN_BINDING = ~0u;
+
+// A shadow copy of the bindings and fixed function state the renderer touches. Every setter compares against the
+// shadow first and only reaches the driver when the value actually changes, counting issued and skipped calls in
+// render_stats(). Anything that changes this state must go through the cache, or call invalidate() afterwards, and
+// objects must be forgotten when they are deleted since GL unbinds them behind our back
+class GLStateCache {
+
+public:
+  // Ctor
+  GLStateCache() {
+    invalidate();
+  }
+
+  GLStateCache(const GLStateCache&) = delete;
+  GLStateCache& operator=(const GLStateCache&) = delete;
+
+  // Forgets everything so the next call of each kind reaches the driver
+  void invalidate() {
+    program_ = UNKNOWN_BINDING;
+    vertex_array_ = UNKNOWN_BINDING;
+    buffers_.fill(UNKNOWN_BINDING);
+    for (auto &range : uniform_ranges_) {
+      range.buffer = UNKNOWN_BINDING;
+    }
+    active_unit_ = UNKNOWN_BINDING;
+    for (auto &unit : textures_) {
+      unit.fill(UNKNOWN_BINDING);
+    }
+    capabilities_.fill(UNKNOWN_BINDING);
+    depth_func_ = UNKNOWN_BINDING;
+    depth_mask_ = UNKNOWN_BINDING;
+    blend_source_ = UNKNOWN_BINDING;
+    blend_destination_ = UNKNOWN_BINDING;
+    framebuffer_ = UNKNOWN_BINDING;
+    viewport_.fill(-1);
+  }
+
+  void use_program(const unsigned int program) {
+    if (skip(program_ == program)) {
+      return;
+    }
+    program_ = program;
+    glUseProgram(program);
+  }
+
+  void bind_vertex_array(const unsigned int vertex_array) {
+    if (skip(vertex_array_ == vertex_array)) {
+      return;
+    }
+    vertex_array_ = vertex_array;
+    // The element array binding is part of the vertex array, so it changes along with it
+    buffers_[buffer_slot(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN_BINDING;
+    glBindVertexArray(vertex_array);
+  }
+
+  void bind_buffer(const GLenum target, const unsigned int buffer) {
+    const std::size_t slot = buffer_slot(target);
+    if (slot < buffers_.size() && skip(buffers_[slot] == buffer)) {
+      return;
+    }
+    if (slot < buffers_.size()) {
+      buffers_[slot] = buffer;
+    }
+    else {
+      ++render_stats().state_calls;
+    }
+    glBindBuffer(target, buffer);
+  }
+
+  // Binds part of a buffer to an indexed binding point. Like glBindBufferRange itself this also replaces the
+  // generic binding of the target
+  void bind_buffer_range(const GLenum target, const unsigned int index, const unsigned int buffer,
+                         const std::size_t offset, const std::size_t size) {
+    const bool shadowed = target == GL_UNIFORM_BUFFER && index < STATE_CACHE_UNIFORM_BINDINGS;
+    if (shadowed) {
+      const BufferRange &range = uniform_ranges_[index];
+      if (skip(range.buffer == buffer && range.offset == offset && range.size == size)) {
+        return;
+      }
+      uniform_ranges_[index] = BufferRange{buffer, offset, size};
+    }
+    else {
+      ++render_stats().state_calls;
+    }
+    const std::size_t slot = buffer_slot(target);
+    if (slot < buffers_.size()) {
+      buffers_[slot] = buffer;
+    }
+    glBindBufferRange(target, index, buffer, offset, size);
+  }
+
+  // Binds to a texture unit, switching the active unit only when the binding really changes
+  void bind_texture(const unsigned int unit, const GLenum target, const unsigned int texture) {
+    const std::size_t slot = texture_slot(target);
+    if (unit >= STATE_CACHE_TEXTURE_UNITS || slot >= textures_[0].size()) {
+      active_texture(unit);
+      ++render_stats().state_calls;
+      glBindTexture(target, texture);
+      return;
+    }
+    if (skip(textures_[unit][slot] == texture)) {
+      return;
+    }
+    textures_[unit][slot] = texture;
+    active_texture(unit);
+    glBindTexture(target, texture);
+  }
+
+  // Binds to whichever unit is active, for creating and filling textures rather than drawing with them
+  void bind_texture(const GLenum target, const unsigned int texture) {
+    if (active_unit_ == UNKNOWN_BINDING) {
+      active_texture(0);
+    }
+    bind_texture(active_unit_, target, texture);
+  }
+
+  void active_texture(const unsigned int unit) {
+    if (skip(active_unit_ == unit)) {
+      return;
+    }
+    active_unit_ = unit;
+    glActiveTexture(GL_TEXTURE0 + unit);
+  }
+
+  void set_enabled(const GLenum capability, const bool enabled) {
+    const std::size_t slot = capability_slot(capability);
+    const unsigned int value = enabled ? 1 : 0;
+    if (slot < capabilities_.size() && skip(capabilities_[slot] == value)) {
+      return;
+    }
+    if (slot < capabilities_.size()) {
+      capabilities_[slot] = value;
+    }
+    else {
+      ++render_stats().state_calls;
+    }
+    if (enabled) {
+      glEnable(capability);
+    }
+    else {
+      glDisable(capability);
+    }
+  }
+
+  void depth_func(const GLenum func) {
+    if (skip(depth_func_ == func)) {
+      return;
+    }
+    depth_func_ = func;
+    glDepthFunc(func);
+  }
+
+  void depth_mask(const bool write) {
+    const unsigned int value = write ? 1 : 0;
+    if (skip(depth_mask_ == value)) {
+      return;
+    }
+    depth_mask_ = value;
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+  }
+
+  void blend_func(const GLenum source, const GLenum destination) {
+    if (skip(blend_source_ == source && blend_destination_ == destination)) {
+      return;
+    }
+    blend_source_ = source;
+    blend_destination_ = destination;
+    glBlendFunc(source, destination);
+  }
+
+  void bind_framebuffer(const unsigned int framebuffer) {
+    if (skip(framebuffer_ == framebuffer)) {
+      return;
+    }
+    framebuffer_ = framebuffer;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  }
+
+  void viewport(const int x, const int y, const int width, const int height) {
+    const std::array<int, 4> viewport = {{x, y, width, height}};
+    if (skip(viewport_ == viewport)) {
+      return;
+    }
+    viewport_ = viewport;
+    glViewport(x, y, width, height);
+  }
+
+  // Called before deleting GL objects, which GL silently unbinds if they are bound
+  void forget_program(const unsigned int program) {
+    if (program_ == program) {
+      program_ = UNKNOWN_BINDING;
+    }
+  }
+
+  void forget_vertex_array(const unsigned int vertex_array) {
+    if (vertex_array_ == vertex_array) {
+      vertex_array_ = UNKNOWN_BINDING;
+    }
+  }
+
+  void forget_buffer(const unsigned int buffer) {
+    for (auto &bound : buffers_) {
+      if (bound == buffer) {
+        bound = UNKNOWN_BINDING;
+      }
+    }
+    for (auto &range : uniform_ranges_) {
+      if (range.buffer == buffer) {
+        range.buffer = UNKNOWN_BINDING;
+      }
+    }
+  }
+
+  void forget_texture(const unsigned int texture) {
+    for (auto &unit : textures_) {
+      for (auto &bound : unit) {
+        if (bound == texture) {
+          bound = UNKNOWN_BINDING;
+        }
+      }
+    }
+  }
+
+  void forget_framebuffer(const unsigned int framebuffer) {
+    if (framebuffer_ == framebuffer) {
+      framebuffer_ = UNKNOWN_BINDING;
+    }
+  }
+
+  unsigned int get_program() const {
+    return program_;
+  }
+
+  unsigned int get_framebuffer() const {
+    return framebuffer_;
+  }
+
+private:
+  struct BufferRange {
+    unsigned int buffer;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  // Counts the call one way or the other and says whether it can be skipped
+  static bool skip(const bool redundant) {
+    if (redundant) {
+      ++render_stats().skipped_state_calls;
+    }
+    else {
+      ++render_stats().state_calls;
+    }
+    return redundant;
+  }
+
+  // Slots for the targets that are shadowed, anything else is passed straight through
+  static std::size_t buffer_slot(const GLenum target) {
+    switch (target) {
+      case GL_ARRAY_BUFFER: return 0;
+      case GL_ELEMENT_ARRAY_BUFFER: return 1;
+      case GL_UNIFORM_BUFFER: return 2;
+      case GL_TEXTURE_BUFFER: return 3;
+      case GL_PIXEL_UNPACK_BUFFER: return 4;
+      case GL_DRAW_INDIRECT_BUFFER: return 5;
+      default: return 6;
+    }
+  }
+
+  static std::size_t texture_slot(const GLenum target) {
+    switch (target) {
+      case GL_TEXTURE_2D: return 0;
+      case GL_TEXTURE_BUFFER: return 1;
+      default: return 2;
+    }
+  }
+
+  static std::size_t capability_slot(const GLenum capability) {
+    switch (capability) {
+      case GL_DEPTH_TEST: return 0;
+      case GL_BLEND: return 1;
+      case GL_CULL_FACE: return 2;
+      case GL_SCISSOR_TEST: return 3;
+      case GL_STENCIL_TEST: return 4;
+      default: return 5;
+    }
+  }
+
+  unsigned int program_ = UNKNOWN_BINDING;
+  unsigned int vertex_array_ = UNKNOWN_BINDING;
+  std::array<unsigned int, 6> buffers_;
+  std::array<BufferRange, STATE_CACHE_UNIFORM_BINDINGS> uniform_ranges_;
+  unsigned int active_unit_ = UNKNOWN_BINDING;
+  std::array<std::array<unsigned int, 2>, STATE_CACHE_TEXTURE_UNITS> textures_;
+  std::array<unsigned int, 5> capabilities_;
+  unsigned int depth_func_ = UNKNOWN_BINDING;
+  unsigned int depth_mask_ = UNKNOWN_BINDING;
+  unsigned int blend_source_ = UNKNOWN_BINDING;
+  unsigned int blend_destination_ = UNKNOWN_BINDING;
+  unsigned int framebuffer_ = UNKNOWN_BINDING;
+  std::array<int, 4> viewport_;
+};
+
+// The state of the one context the application renders with
+inline GLStateCache& gl_state() {
+  static GLStateCache cache;
+  return cache;
+}
+
+#endif /* gl_state_cache_h */
@@ -0,0 +1,451 @@
+//
+//  gltf_loader.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef gltf_loader_h
+#define gltf_loader_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Local Includes
+#include "json.hpp"
+#include "mapped_file.hpp"
+#include "mesh.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_inverse.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+// GLB container, see the glTF 2.0 specification section 4.4
+const std::uint32_t GLB_MAGIC = 0x46546C67;
+const std::uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+const std::uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+namespace gltf {
+
+// Accessor component types
+const int BYTE = 5120;
+const int UNSIGNED_BYTE = 5121;
+const int SHORT = 5122;
+const int UNSIGNED_SHORT = 5123;
+const int UNSIGNED_INT = 5125;
+const int FLOAT = 5126;
+
+const int MODE_TRIANGLES = 4;
+
+// The document and every buffer it refers to
+struct Asset {
+  JsonValue json;
+  std::vector<std::vector<unsigned char>> buffers;
+};
+
+inline std::string directory_of(const std::string &path) {
+  const std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+inline bool read_file(const std::string &path, std::vector<unsigned char> &bytes) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return true;
+}
+
+// Buffers embedded as data URIs
+inline bool decode_base64(const std::string &text, const std::size_t begin, std::vector<unsigned char> &bytes) {
+  static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  unsigned int accumulator = 0;
+  int bits = 0;
+  for (std::size_t i = begin; i < text.size() && text[i] != '='; i++) {
+    const char *found = text[i] != '\0' ? std::strchr(ALPHABET, text[i]) : nullptr;
+    if (found == nullptr) {
+      return false;
+    }
+
+    accumulator = (accumulator << 6) | static_cast<unsigned int>(found - ALPHABET);
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      bytes.push_back(static_cast<unsigned char>((accumulator >> bits) & 0xFF));
+    }
+  }
+  return true;
+}
+
+// Reads the JSON chunk of a .glb file or a whole .gltf file, and then every buffer. The binary chunk of a .glb
+// file is the buffer without a uri
+inline bool read_asset(const std::string &path, Asset &asset) {
+  MappedFile file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  const unsigned char *data = file.get_data();
+  const std::size_t size = file.get_size();
+
+  std::vector<unsigned char> binary_chunk;
+  bool parsed = false;
+  std::uint32_t magic = 0;
+  if (size >= 12) {
+    std::memcpy(&magic, data, 4);
+  }
+  if (magic == GLB_MAGIC) {
+    std::size_t offset = 12;
+    while (offset + 8 <= size) {
+      std::uint32_t chunk_length, chunk_type;
+      std::memcpy(&chunk_length, data + offset, 4);
+      std::memcpy(&chunk_type, data + offset + 4, 4);
+      offset += 8;
+      if (chunk_length > size - offset) {
+        return false;
+      }
+      if (chunk_type == GLB_CHUNK_JSON) {
+        const char *json = reinterpret_cast<const char*>(data + offset);
+        parsed = JsonValue::parse(json, json + chunk_length, asset.json);
+      }
+      else if (chunk_type == GLB_CHUNK_BIN && binary_chunk.empty()) {
+        binary_chunk.assign(data + offset, data + offset + chunk_length);
+      }
+      offset += (chunk_length + 3) & ~std::size_t(3);
+    }
+  }
+  else {
+    const char *json = reinterpret_cast<const char*>(data);
+    parsed = JsonValue::parse(json, json + size, asset.json);
+  }
+  if (!parsed) {
+    return false;
+  }
+
+  const JsonValue &buffers = asset.json["buffers"];
+  asset.buffers.resize(buffers.size());
+  for (std::size_t i = 0; i < buffers.size(); i++) {
+    const JsonValue &buffer = buffers[i];
+    std::vector<unsigned char> &bytes = asset.buffers[i];
+    if (!buffer.has("uri")) {
+      bytes.swap(binary_chunk);
+    }
+    else {
+      const std::string &uri = buffer["uri"].as_string();
+      if (uri.compare(0, 5, "data:") == 0) {
+        const std::size_t comma = uri.find(',');
+        if (comma == std::string::npos || !decode_base64(uri, comma + 1, bytes)) {
+          return false;
+        }
+      }
+      else if (!read_file(directory_of(path) + uri, bytes)) {
+        return false;
+      }
+    }
+
+    if (bytes.size() < static_cast<std::size_t>(buffer["byteLength"].as_number())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline int component_count(const std::string &type) {
+  const char *TYPES[] = {"SCALAR", "VEC2", "VEC3", "VEC4"};
+  for (int i = 0; i < 4; i++) {
+    if (type == TYPES[i]) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+inline std::size_t component_size(const int component_type) {
+  switch (component_type) {
+    case BYTE:
+    case UNSIGNED_BYTE:
+      return 1;
+    case SHORT:
+    case UNSIGNED_SHORT:
+      return 2;
+    case UNSIGNED_INT:
+    case FLOAT:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// One component as a float, normalized integers map to [0, 1] or [-1, 1] the way the GPU would read them
+inline float read_component(const unsigned char *p, const int component_type, const bool normalized) {
+  switch (component_type) {
+    case FLOAT: {
+      float value;
+      std::memcpy(&value, p, 4);
+      return value;
+    }
+    case UNSIGNED_BYTE:
+      return normalized ? *p / 255.0f : *p;
+    case BYTE: {
+      const float value = static_cast<float>(static_cast<std::int8_t>(*p));
+      return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case UNSIGNED_SHORT: {
+      std::uint16_t value;
+      std::memcpy(&value, p, 2);
+      return normalized ? value / 65535.0f : value;
+    }
+    case SHORT: {
+      std::int16_t value;
+      std::memcpy(&value, p, 2);
+      return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    case UNSIGNED_INT: {
+      std::uint32_t value;
+      std::memcpy(&value, p, 4);
+      return static_cast<float>(value);
+    }
+    default:
+      return 0.0f;
+  }
+}
+
+// Reads up to four components per element of an accessor into out, which is resized to count * components.
+// Sparse accessors are not supported
+inline bool read_accessor(const Asset &asset, const int index, const int components, std::vector<float> &out) {
+  const JsonValue &accessor = asset.json["accessors"][static_cast<std::size_t>(index)];
+  const JsonValue &view = asset.json["bufferViews"][static_cast<std::size_t>(accessor["bufferView"].as_int(-1))];
+  const int buffer_index = view["buffer"].as_int(-1);
+  if (!accessor.is_object() || !view.is_object() || buffer_index < 0 ||
+      static_cast<std::size_t>(buffer_index) >= asset.buffers.size() || accessor.has("sparse")) {
+    return false;
+  }
+
+  const int component_type = accessor["componentType"].as_int();
+  const int accessor_components = component_count(accessor["type"].as_string());
+  const std::size_t element_size = component_size(component_type) * accessor_components;
+  const std::size_t count = static_cast<std::size_t>(accessor["count"].as_number());
+  const std::size_t stride = view.has("byteStride") ? static_cast<std::size_t>(view["byteStride"].as_number())
+                                                    : element_size;
+  const std::size_t offset = static_cast<std::size_t>(view["byteOffset"].as_number()) +
+                             static_cast<std::size_t>(accessor["byteOffset"].as_number());
+  const std::vector<unsigned char> &buffer = asset.buffers[static_cast<std::size_t>(buffer_index)];
+  if (element_size == 0 || accessor_components < components ||
+      (count > 0 && offset + (count - 1) * stride + element_size > buffer.size())) {
+    return false;
+  }
+
+  const bool normalized = accessor["normalized"].as_bool();
+  const std::size_t size = component_size(component_type);
+  out.resize(count * components);
+  for (std::size_t i = 0; i < count; i++) {
+    const unsigned char *element = buffer.data() + offset + i * stride;
+    for (int c = 0; c < components; c++) {
+      out[i * components + c] = read_component(element + c * size, component_type, normalized);
+    }
+  }
+  return true;
+}
+
+// Index accessors are read as integers, floats would lose indices past 2^24
+inline bool read_indices(const Asset &asset, const int index, std::vector<std::uint32_t> &out) {
+  const JsonValue &accessor = asset.json["accessors"][static_cast<std::size_t>(index)];
+  const int component_type = accessor["componentType"].as_int();
+  if (component_type != UNSIGNED_BYTE && component_type != UNSIGNED_SHORT && component_type != UNSIGNED_INT) {
+    return false;
+  }
+
+  // Integers up to 16 bits are exact as floats, only 32-bit indices need reading on their own
+  if (component_type != UNSIGNED_INT) {
+    std::vector<float> values;
+    if (!read_accessor(asset, index, 1, values)) {
+      return false;
+    }
+    out.assign(values.begin(), values.end());
+    return true;
+  }
+
+  const JsonValue &view = asset.json["bufferViews"][static_cast<std::size_t>(accessor["bufferView"].as_int(-1))];
+  const int buffer_index = view["buffer"].as_int(-1);
+  if (buffer_index < 0 || static_cast<std::size_t>(buffer_index) >= asset.buffers.size()) {
+    return false;
+  }
+  const std::size_t count = static_cast<std::size_t>(accessor["count"].as_number());
+  const std::size_t stride = view.has("byteStride") ? static_cast<std::size_t>(view["byteStride"].as_number()) : 4;
+  const std::size_t offset = static_cast<std::size_t>(view["byteOffset"].as_number()) +
+                             static_cast<std::size_t>(accessor["byteOffset"].as_number());
+  const std::vector<unsigned char> &buffer = asset.buffers[static_cast<std::size_t>(buffer_index)];
+  if (count > 0 && offset + (count - 1) * stride + 4 > buffer.size()) {
+    return false;
+  }
+
+  out.resize(count);
+  for (std::size_t i = 0; i < count; i++) {
+    std::memcpy(&out[i], buffer.data() + offset + i * stride, 4);
+  }
+  return true;
+}
+
+inline glm::mat4 node_transform(const JsonValue &node) {
+  const JsonValue &matrix = node["matrix"];
+  if (matrix.size() == 16) {
+    glm::mat4 result;
+    for (int i = 0; i < 16; i++) {
+      glm::value_ptr(result)[i] = static_cast<float>(matrix[static_cast<std::size_t>(i)].as_number());
+    }
+    return result;
+  }
+
+  const JsonValue &t = node["translation"];
+  const JsonValue &r = node["rotation"];
+  const JsonValue &s = node["scale"];
+  const glm::vec3 translation(t[0].as_number(), t[1].as_number(), t[2].as_number());
+  const glm::quat rotation(static_cast<float>(r[3].as_number(1.0)), static_cast<float>(r[0].as_number()),
+                           static_cast<float>(r[1].as_number()), static_cast<float>(r[2].as_number()));
+  const glm::vec3 scale(s[0].as_number(1.0), s[1].as_number(1.0), s[2].as_number(1.0));
+  return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) *
+         glm::scale(glm::mat4(1.0f), scale);
+}
+
+// Appends the triangles of one primitive, moved into world space by transform. Primitives without normals get
+// smooth ones from their faces
+inline bool append_primitive(const Asset &asset, const JsonValue &primitive, const glm::mat4 &transform,
+                             MeshData &mesh) {
+  const JsonValue &attributes = primitive["attributes"];
+  std::vector<float> positions, normals, tex_coords;
+  std::vector<std::uint32_t> indices;
+  if (!read_accessor(asset, attributes["POSITION"].as_int(-1), 3, positions)) {
+    return false;
+  }
+  const std::size_t vertex_count = positions.size() / 3;
+  if (attributes.has("NORMAL") && (!read_accessor(asset, attributes["NORMAL"].as_int(), 3, normals) ||
+                                   normals.size() != vertex_count * 3)) {
+    return false;
+  }
+  if (attributes.has("TEXCOORD_0") && (!read_accessor(asset, attributes["TEXCOORD_0"].as_int(), 2, tex_coords) ||
+                                       tex_coords.size() != vertex_count * 2)) {
+    return false;
+  }
+  if (primitive.has("indices")) {
+    if (!read_indices(asset, primitive["indices"].as_int(), indices)) {
+      return false;
+    }
+  }
+  else {
+    indices.resize(vertex_count);
+    for (std::size_t i = 0; i < vertex_count; i++) {
+      indices[i] = static_cast<std::uint32_t>(i);
+    }
+  }
+
+  const std::size_t base = mesh.vertices.size();
+  const glm::mat3 normal_matrix = glm::inverseTranspose(glm::mat3(transform));
+  mesh.vertices.resize(base + vertex_count);
+  for (std::size_t i = 0; i < vertex_count; i++) {
+    Vertex &vertex = mesh.vertices[base + i];
+    vertex.position = glm::vec3(transform * glm::vec4(positions[i * 3], positions[i * 3 + 1],
+                                                      positions[i * 3 + 2], 1.0f));
+    vertex.normal = normals.empty() ? glm::vec3(0.0f) :
+                    glm::normalize(normal_matrix * glm::vec3(normals[i * 3], normals[i * 3 + 1],
+                                                             normals[i * 3 + 2]));
+    vertex.tex_coords = tex_coords.empty() ? glm::vec2(0.0f) : glm::vec2(tex_coords[i * 2], tex_coords[i * 2 + 1]);
+  }
+
+  // A mirroring transform turns the triangles inside out, swapping two corners turns them back
+  const bool mirrored = glm::determinant(glm::mat3(transform)) < 0.0f;
+  for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+    std::uint32_t triangle[3];
+    for (int k = 0; k < 3; k++) {
+      const std::size_t index = static_cast<std::size_t>(indices[i + k]);
+      if (index >= vertex_count) {
+        return false;
+      }
+      triangle[k] = static_cast<std::uint32_t>(base + index);
+    }
+    if (mirrored) {
+      std::swap(triangle[1], triangle[2]);
+    }
+    mesh.indices.insert(mesh.indices.end(), triangle, triangle + 3);
+
+    if (normals.empty()) {
+      Vertex *corners[3] = {&mesh.vertices[triangle[0]], &mesh.vertices[triangle[1]], &mesh.vertices[triangle[2]]};
+      const glm::vec3 face = glm::cross(corners[1]->position - corners[0]->position,
+                                        corners[2]->position - corners[0]->position);
+      for (Vertex *corner : corners) {
+        corner->normal += face;
+      }
+    }
+  }
+  if (normals.empty()) {
+    for (std::size_t i = base; i < mesh.vertices.size(); i++) {
+      const float length = glm::length(mesh.vertices[i].normal);
+      mesh.vertices[i].normal = length > 0.0f ? mesh.vertices[i].normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+    }
+  }
+  return true;
+}
+
+inline bool append_node(const Asset &asset, const std::size_t index, const glm::mat4 &parent, MeshData &mesh,
+                        const int depth) {
+  const JsonValue &node = asset.json["nodes"][index];
+  if (!node.is_object() || depth > 64) {
+    return false;
+  }
+
+  const glm::mat4 transform = parent * node_transform(node);
+  if (node.has("mesh")) {
+    const JsonValue &primitives = asset.json["meshes"][static_cast<std::size_t>(node["mesh"].as_int())]["primitives"];
+    for (std::size_t i = 0; i < primitives.size(); i++) {
+      // Points and lines have nothing to shade
+      if (primitives[i]["mode"].as_int(MODE_TRIANGLES) != MODE_TRIANGLES) {
+        continue;
+      }
+      if (!append_primitive(asset, primitives[i], transform, mesh)) {
+        return false;
+      }
+    }
+  }
+
+  const JsonValue &children = node["children"];
+  for (std::size_t i = 0; i < children.size(); i++) {
+    if (!append_node(asset, static_cast<std::size_t>(children[i].as_int()), transform, mesh, depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+// Loads every triangle of the default scene of a glTF 2.0 file, .gltf with its buffers or a binary .glb, into one
+// indexed mesh with node transforms applied. Materials, skins and animations are ignored
+inline bool load_gltf(const std::string &path, MeshData &mesh) {
+  gltf::Asset asset;
+  if (!gltf::read_asset(path, asset)) {
+    std::cerr << "glTF file could not be read: " << path << "\n";
+    return false;
+  }
+
+  mesh = MeshData();
+  const JsonValue &scene = asset.json["scenes"][static_cast<std::size_t>(asset.json["scene"].as_int())];
+  const JsonValue &nodes = scene["nodes"];
+  for (std::size_t i = 0; i < nodes.size(); i++) {
+    if (!gltf::append_node(asset, static_cast<std::size_t>(nodes[i].as_int()), glm::mat4(1.0f), mesh, 0)) {
+      std::cerr << "glTF file has a broken node or accessor: " << path << "\n";
+      return false;
+    }
+  }
+  return !mesh.indices.empty();
+}
+
+#endif /* gltf_loader_h */
@@ -0,0 +1,135 @@
+//
+//  headless_context.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef headless_context_h
+#define headless_context_h
+
+#ifdef OPENGL_HAS_EGL
+
+// Library Includes
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+// System Includes
+#include <cstring>
+#include <iostream>
+
+// An OpenGL 3.3 core context with no window, for render nodes and CI boxes without a display. On Mesa without
+// a GPU this lands on llvmpipe. Rendering goes into a Framebuffer since the pbuffer is only a placeholder
+class HeadlessContext {
+
+public:
+  // Ctor
+  HeadlessContext() {
+    display_ = open_display();
+    if (display_ == EGL_NO_DISPLAY) {
+      std::cerr << "EGL: no display available\n";
+      return;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+      std::cerr << "EGL: desktop OpenGL is not supported\n";
+      return;
+    }
+
+    const EGLint config_attributes[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_RED_SIZE, 8,
+      EGL_GREEN_SIZE, 8,
+      EGL_BLUE_SIZE, 8,
+      EGL_DEPTH_SIZE, 24,
+      EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint config_count = 0;
+    eglChooseConfig(display_, config_attributes, &config, 1, &config_count);
+
+    const EGLint context_attributes[] = {
+      EGL_CONTEXT_MAJOR_VERSION, 3,
+      EGL_CONTEXT_MINOR_VERSION, 3,
+      EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+      EGL_NONE
+    };
+
+    // Surfaceless platforms have no pbuffer configs, in which case the context is made current with no surface
+    if (config_count > 0) {
+      const EGLint surface_attributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+      surface_ = eglCreatePbufferSurface(display_, config, surface_attributes);
+    }
+    context_ = eglCreateContext(display_, config_count > 0 ? config : nullptr, EGL_NO_CONTEXT, context_attributes);
+    if (context_ == EGL_NO_CONTEXT) {
+      std::cerr << "EGL: failed to create an OpenGL 3.3 core context (0x" << std::hex << eglGetError() << std::dec << ")\n";
+      return;
+    }
+
+    if (!eglMakeCurrent(display_, surface_, surface_, context_)) {
+      std::cerr << "EGL: failed to make the context current (0x" << std::hex << eglGetError() << std::dec << ")\n";
+      return;
+    }
+    valid_ = true;
+  }
+
+  // Dtor
+  ~HeadlessContext() {
+    if (display_ == EGL_NO_DISPLAY) {
+      return;
+    }
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context_ != EGL_NO_CONTEXT) {
+      eglDestroyContext(display_, context_);
+    }
+    if (surface_ != EGL_NO_SURFACE) {
+      eglDestroySurface(display_, surface_);
+    }
+    eglTerminate(display_);
+  }
+
+  HeadlessContext(const HeadlessContext&) = delete;
+  HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+  bool is_valid() const {
+    return valid_;
+  }
+
+  static void *get_proc_address(const char *name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+  }
+
+private:
+  // Prefers Mesa's surfaceless platform, which needs neither X nor a GPU, then whatever the default display is
+  static EGLDisplay open_display() {
+    const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    const char *client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    EGLint major, minor;
+    if (get_platform_display != nullptr && client_extensions != nullptr &&
+        std::strstr(client_extensions, "EGL_MESA_platform_surfaceless") != nullptr) {
+      EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+      if (display != EGL_NO_DISPLAY && eglInitialize(display, &major, &minor)) {
+        return display;
+      }
+    }
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, &major, &minor)) {
+      return display;
+    }
+    return EGL_NO_DISPLAY;
+  }
+
+  EGLDisplay display_ = EGL_NO_DISPLAY;
+  EGLSurface surface_ = EGL_NO_SURFACE;
+  EGLContext context_ = EGL_NO_CONTEXT;
+  bool valid_ = false;
+};
+
+#endif /* OPENGL_HAS_EGL */
+
+#endif /* headless_context_h */
@@ -0,0 +1,186 @@
+//
+//  image_decoder.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef image_decoder_h
+#define image_decoder_h
+
+// System Includes
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local Includes
+#include "ktx.hpp"
+#include "stb_image.h"
+
+// Pixels decoded from an image file, or the compressed mip chain read from a KTX file. Neither is set if the
+// file could not be read
+struct DecodedImage {
+  std::string path;
+  int width = 0;
+  int height = 0;
+  int components = 0;
+  std::unique_ptr<unsigned char, void (*)(void*)> pixels{nullptr, stbi_image_free};
+  KtxImage compressed;
+
+  bool is_valid() const {
+    return pixels != nullptr || is_compressed();
+  }
+
+  bool is_compressed() const {
+    return !compressed.levels.empty();
+  }
+
+  std::size_t get_bytes() const {
+    if (is_compressed()) {
+      return compressed.get_bytes();
+    }
+    return static_cast<std::size_t>(width) * height * components;
+  }
+};
+
+// Decodes source and files the result under path
+inline DecodedImage decode_image(const std::string &path, const std::string &source) {
+  DecodedImage image;
+  image.path = path;
+
+  const std::string extension = ".ktx";
+  if (source.size() > extension.size() &&
+      source.compare(source.size() - extension.size(), extension.size(), extension) == 0) {
+    if (read_ktx(source, image.compressed)) {
+      image.width = image.compressed.levels[0].width;
+      image.height = image.compressed.levels[0].height;
+    }
+    else {
+      image.compressed.levels.clear();
+    }
+    return image;
+  }
+
+  image.pixels.reset(stbi_load(source.c_str(), &image.width, &image.height, &image.components, 0));
+  return image;
+}
+
+// Decodes image files on a pool of worker threads. Paths go in with submit() and decoded images come back out of
+// try_pop() in whatever order they finish. Nothing here touches GL, so uploading stays on the render thread
+class ImageDecoder {
+
+public:
+  // Ctor
+  explicit ImageDecoder(const std::size_t thread_count = default_thread_count()) {
+    for (std::size_t i = 0; i < thread_count; i++) {
+      workers_.emplace_back([this]() { work(); });
+    }
+  }
+
+  // Dtor. Finishes the file being decoded by each worker and drops everything still queued
+  ~ImageDecoder() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ImageDecoder(const ImageDecoder&) = delete;
+  ImageDecoder& operator=(const ImageDecoder&) = delete;
+
+  // Decodes source, which comes back out as an image filed under path
+  void submit(const std::string &path, const std::string &source) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_.push_back(Job{path, source});
+      ++in_flight_;
+    }
+    wake_.notify_one();
+  }
+
+  // Hands over one finished image if there is one. Never blocks on a decode
+  bool try_pop(DecodedImage &image) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_.empty()) {
+      return false;
+    }
+    image = std::move(finished_.front());
+    finished_.pop_front();
+    --in_flight_;
+    return true;
+  }
+
+  // Hands over one finished image, waiting for a worker to finish one if needed. Returns false straight away
+  // when nothing is in flight
+  bool pop(DecodedImage &image) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return !finished_.empty() || in_flight_ == 0; });
+    if (finished_.empty()) {
+      return false;
+    }
+    image = std::move(finished_.front());
+    finished_.pop_front();
+    --in_flight_;
+    return true;
+  }
+
+  // Images submitted but not yet popped
+  std::size_t get_in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_;
+  }
+
+  // Leaves a core for the render thread
+  static std::size_t default_thread_count() {
+    const std::size_t cores = std::thread::hardware_concurrency();
+    return std::max<std::size_t>(cores > 1 ? cores - 1 : 1, 1);
+  }
+
+private:
+  struct Job {
+    std::string path;
+    std::string source;
+  };
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [this]() { return stopping_ || !queued_.empty(); });
+      if (stopping_) {
+        return;
+      }
+
+      Job job = std::move(queued_.front());
+      queued_.pop_front();
+
+      lock.unlock();
+      DecodedImage image = decode_image(job.path, job.source);
+      lock.lock();
+
+      finished_.push_back(std::move(image));
+      done_.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::deque<Job> queued_;
+  std::deque<DecodedImage> finished_;
+  std::size_t in_flight_ = 0;
+  bool stopping_ = false;
+};
+
+#endif /* image_decoder_h */
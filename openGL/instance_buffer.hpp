@@ -0,0 +1,115 @@
+//
+//  instance_buffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef instance_buffer_h
+#define instance_buffer_h
+
+// System Includes
+#include <cstddef>
+#include <cstring>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "glm/glm.hpp"
+
+// What the vertex shader receives for each instance. The normal matrix is computed on the CPU once per
+// model matrix instead of once per vertex
+struct InstanceData {
+  glm::mat4 model;
+  glm::mat3 normal;
+};
+
+// Wires instances stored in buffer from byte offset on into the vertex array. The model matrix is fed to the vertex
+// shader as a mat4 attribute spread over four consecutive locations from first_location and the normal matrix as
+// a mat3 over the next three, each advancing once per instance
+inline void attach_instances(const unsigned int vao, const unsigned int buffer, const std::size_t offset,
+                             const unsigned int first_location) {
+  gl_state().bind_vertex_array(vao);
+  gl_state().bind_buffer(GL_ARRAY_BUFFER, buffer);
+  for (unsigned int column = 0; column < 4; column++) {
+    glVertexAttribPointer(first_location + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(offset + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+    glEnableVertexAttribArray(first_location + column);
+    glVertexAttribDivisor(first_location + column, 1);
+  }
+  for (unsigned int column = 0; column < 3; column++) {
+    glVertexAttribPointer(first_location + 4 + column, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(offset + offsetof(InstanceData, normal) + column * sizeof(glm::vec3)));
+    glEnableVertexAttribArray(first_location + 4 + column);
+    glVertexAttribDivisor(first_location + 4 + column, 1);
+  }
+}
+
+// Per-instance data stored in a vertex buffer of its own, see attach_instances()
+class InstanceBuffer {
+
+public:
+  // Ctor
+  explicit InstanceBuffer(const std::size_t capacity = 0) {
+    glGenBuffers(1, &id_);
+    reserve(capacity);
+  }
+
+  // Dtor
+  ~InstanceBuffer() {
+    gl_state().forget_buffer(id_);
+    glDeleteBuffers(1, &id_);
+  }
+
+  InstanceBuffer(const InstanceBuffer&) = delete;
+  InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+  // Wires the buffer into the vertex array at locations first_location..first_location + 6. Instance 0 of a draw
+  // reads first_instance, which is how draws start partway into the buffer without base instance support
+  void attach(const unsigned int vao, const unsigned int first_location, const std::size_t first_instance = 0) const {
+    attach_instances(vao, id_, first_instance * sizeof(InstanceData), first_location);
+  }
+
+  // Grows the GPU storage so that at least capacity instances fit. Existing contents are discarded
+  void reserve(const std::size_t capacity) {
+    if (capacity <= capacity_ && capacity_ != 0) {
+      return;
+    }
+    capacity_ = capacity == 0 ? 1 : capacity;
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, id_);
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+  }
+
+  // Replaces the buffer contents. The old storage is invalidated so the copy never waits on draws still
+  // reading last frame's instances
+  void upload(const InstanceData *instances, const std::size_t count) {
+    reserve(count);
+    count_ = count;
+    if (count == 0) {
+      return;
+    }
+
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, id_);
+    void *destination = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData),
+                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (destination != nullptr) {
+      std::memcpy(destination, instances, count * sizeof(InstanceData));
+      glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+  }
+
+  std::size_t size() const {
+    return count_;
+  }
+
+  unsigned int get_id() const {
+    return id_;
+  }
+
+private:
+  unsigned int id_ = 0;
+  std::size_t capacity_ = 0;
+  std::size_t count_ = 0;
+};
+
+#endif /* instance_buffer_h */
@@ -0,0 +1,305 @@
+//
+//  json.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef json_h
+#define json_h
+
+// System Includes
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A parsed JSON document. Just enough for asset descriptions like glTF, where documents are small and the bulk
+// of the data lives in binary buffers
+class JsonValue {
+
+public:
+  enum Type {
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT
+  };
+
+  Type get_type() const {
+    return type_;
+  }
+
+  bool is_null() const {
+    return type_ == JSON_NULL;
+  }
+
+  bool is_number() const {
+    return type_ == JSON_NUMBER;
+  }
+
+  bool is_array() const {
+    return type_ == JSON_ARRAY;
+  }
+
+  bool is_object() const {
+    return type_ == JSON_OBJECT;
+  }
+
+  bool has(const std::string &key) const {
+    return members_.find(key) != members_.end();
+  }
+
+  // Member lookups and indexing never fail, anything missing comes back as null
+  const JsonValue& operator[](const std::string &key) const {
+    const auto it = members_.find(key);
+    return it != members_.end() ? it->second : null_value();
+  }
+
+  const JsonValue& operator[](const std::size_t index) const {
+    return index < elements_.size() ? elements_[index] : null_value();
+  }
+
+  std::size_t size() const {
+    return type_ == JSON_ARRAY ? elements_.size() : members_.size();
+  }
+
+  double as_number(const double fallback = 0.0) const {
+    return type_ == JSON_NUMBER ? number_ : fallback;
+  }
+
+  int as_int(const int fallback = 0) const {
+    return type_ == JSON_NUMBER ? static_cast<int>(number_) : fallback;
+  }
+
+  bool as_bool(const bool fallback = false) const {
+    return type_ == JSON_BOOL ? boolean_ : fallback;
+  }
+
+  const std::string& as_string() const {
+    return string_;
+  }
+
+  // Parses a whole document. Returns false and leaves value null on malformed input
+  static bool parse(const char *begin, const char *end, JsonValue &value) {
+    Parser parser{begin, end};
+    value = JsonValue();
+    if (!parser.parse_value(value, 0)) {
+      value = JsonValue();
+      return false;
+    }
+    parser.skip_whitespace();
+    return parser.at == parser.end;
+  }
+
+private:
+  // Deep enough for any sane asset, shallow enough that malicious nesting cannot blow the stack
+  static const int MAX_DEPTH = 64;
+
+  struct Parser {
+    const char *at;
+    const char *end;
+
+    void skip_whitespace() {
+      while (at < end && (*at == ' ' || *at == '\t' || *at == '\n' || *at == '\r')) {
+        ++at;
+      }
+    }
+
+    bool consume(const char *literal) {
+      const char *p = at;
+      for (; *literal != '\0'; ++literal, ++p) {
+        if (p == end || *p != *literal) {
+          return false;
+        }
+      }
+      at = p;
+      return true;
+    }
+
+    bool parse_value(JsonValue &value, const int depth) {
+      skip_whitespace();
+      if (at == end || depth > MAX_DEPTH) {
+        return false;
+      }
+
+      switch (*at) {
+        case '{':
+          return parse_object(value, depth);
+        case '[':
+          return parse_array(value, depth);
+        case '"':
+          value.type_ = JSON_STRING;
+          return parse_string(value.string_);
+        case 't':
+          value.type_ = JSON_BOOL;
+          value.boolean_ = true;
+          return consume("true");
+        case 'f':
+          value.type_ = JSON_BOOL;
+          value.boolean_ = false;
+          return consume("false");
+        case 'n':
+          value.type_ = JSON_NULL;
+          return consume("null");
+        default:
+          return parse_number(value);
+      }
+    }
+
+    bool parse_object(JsonValue &value, const int depth) {
+      value.type_ = JSON_OBJECT;
+      ++at;
+      skip_whitespace();
+      if (at < end && *at == '}') {
+        ++at;
+        return true;
+      }
+
+      for (;;) {
+        skip_whitespace();
+        std::string key;
+        if (at == end || *at != '"' || !parse_string(key)) {
+          return false;
+        }
+        skip_whitespace();
+        if (at == end || *at != ':') {
+          return false;
+        }
+        ++at;
+        if (!parse_value(value.members_[key], depth + 1)) {
+          return false;
+        }
+
+        skip_whitespace();
+        if (at == end) {
+          return false;
+        }
+        if (*at == '}') {
+          ++at;
+          return true;
+        }
+        if (*at != ',') {
+          return false;
+        }
+        ++at;
+      }
+    }
+
+    bool parse_array(JsonValue &value, const int depth) {
+      value.type_ = JSON_ARRAY;
+      ++at;
+      skip_whitespace();
+      if (at < end && *at == ']') {
+        ++at;
+        return true;
+      }
+
+      for (;;) {
+        value.elements_.emplace_back();
+        if (!parse_value(value.elements_.back(), depth + 1)) {
+          return false;
+        }
+
+        skip_whitespace();
+        if (at == end) {
+          return false;
+        }
+        if (*at == ']') {
+          ++at;
+          return true;
+        }
+        if (*at != ',') {
+          return false;
+        }
+        ++at;
+      }
+    }
+
+    // Escapes are decoded, \u only for the Basic Multilingual Plane, which is all asset names ever need
+    bool parse_string(std::string &out) {
+      ++at;
+      while (at < end && *at != '"') {
+        if (*at != '\\') {
+          out.push_back(*at++);
+          continue;
+        }
+        if (++at == end) {
+          return false;
+        }
+        const char escape = *at++;
+        switch (escape) {
+          case 'b': out.push_back('\b'); break;
+          case 'f': out.push_back('\f'); break;
+          case 'n': out.push_back('\n'); break;
+          case 'r': out.push_back('\r'); break;
+          case 't': out.push_back('\t'); break;
+          case 'u': {
+            if (end - at < 4) {
+              return false;
+            }
+            const std::string hex(at, at + 4);
+            at += 4;
+            const unsigned long code = std::strtoul(hex.c_str(), nullptr, 16);
+            if (code < 0x80) {
+              out.push_back(static_cast<char>(code));
+            }
+            else if (code < 0x800) {
+              out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+              out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else {
+              out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+              out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+              out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            break;
+          }
+          default: out.push_back(escape); break;
+        }
+      }
+      if (at == end) {
+        return false;
+      }
+      ++at;
+      return true;
+    }
+
+    bool parse_number(JsonValue &value) {
+      // Read through the classic locale, strtod would take a comma for the decimal point in some locales
+      const char *start = at;
+      while (at < end && *at != '\0' && (std::strchr("+-.eE", *at) != nullptr || (*at >= '0' && *at <= '9'))) {
+        ++at;
+      }
+      if (at == start) {
+        return false;
+      }
+      std::istringstream text(std::string(start, at));
+      text.imbue(std::locale::classic());
+      value.type_ = JSON_NUMBER;
+      text >> value.number_;
+      return !text.fail() && text.peek() == std::char_traits<char>::eof();
+    }
+  };
+
+  static const JsonValue& null_value() {
+    static const JsonValue value;
+    return value;
+  }
+
+  Type type_ = JSON_NULL;
+  bool boolean_ = false;
+  double number_ = 0.0;
+  std::string string_;
+  std::vector<JsonValue> elements_;
+  std::map<std::string, JsonValue> members_;
+};
+
+#endif /* json_h */
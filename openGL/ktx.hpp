@@ -0,0 +1,177 @@
+//
+//  ktx.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef ktx_h
+#define ktx_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compressed internal formats written by the texture compressor. Spelled out here so the offline tool builds
+// without GL headers
+const std::uint32_t KTX_COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+const std::uint32_t KTX_COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+const std::uint32_t KTX_COMPRESSED_RG_RGTC2 = 0x8DBD;
+const std::uint32_t KTX_COMPRESSED_RG11_EAC = 0x9272;
+const std::uint32_t KTX_COMPRESSED_RGB8_ETC2 = 0x9274;
+const std::uint32_t KTX_COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+
+const std::uint32_t KTX_RG = 0x8227;
+const std::uint32_t KTX_RGB = 0x1907;
+const std::uint32_t KTX_RGBA = 0x1908;
+
+// Bytes per 4x4 block of a compressed format, 0 for formats we do not know
+inline std::size_t ktx_block_bytes(const std::uint32_t internal_format) {
+  switch (internal_format) {
+    case KTX_COMPRESSED_RGB_S3TC_DXT1:
+    case KTX_COMPRESSED_RGB8_ETC2:
+      return 8;
+    case KTX_COMPRESSED_RGBA_S3TC_DXT5:
+    case KTX_COMPRESSED_RG_RGTC2:
+    case KTX_COMPRESSED_RG11_EAC:
+    case KTX_COMPRESSED_RGBA8_ETC2_EAC:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+inline std::size_t ktx_level_bytes(const std::uint32_t internal_format, const int width, const int height) {
+  return static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * ktx_block_bytes(internal_format);
+}
+
+struct KtxLevel {
+  int width = 0;
+  int height = 0;
+  std::vector<unsigned char> data;
+};
+
+// A compressed 2D texture with its whole mip chain, largest level first
+struct KtxImage {
+  std::uint32_t internal_format = 0;
+  std::uint32_t base_internal_format = 0;
+  std::vector<KtxLevel> levels;
+
+  std::size_t get_bytes() const {
+    std::size_t bytes = 0;
+    for (const KtxLevel &level : levels) {
+      bytes += level.data.size();
+    }
+    return bytes;
+  }
+};
+
+// KTX 1.1 header, https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html
+struct KtxHeader {
+  unsigned char identifier[12];
+  std::uint32_t endianness;
+  std::uint32_t gl_type;
+  std::uint32_t gl_type_size;
+  std::uint32_t gl_format;
+  std::uint32_t gl_internal_format;
+  std::uint32_t gl_base_internal_format;
+  std::uint32_t pixel_width;
+  std::uint32_t pixel_height;
+  std::uint32_t pixel_depth;
+  std::uint32_t number_of_array_elements;
+  std::uint32_t number_of_faces;
+  std::uint32_t number_of_mipmap_levels;
+  std::uint32_t bytes_of_key_value_data;
+};
+
+static_assert(sizeof(KtxHeader) == 64, "KTX header must be 64 bytes");
+
+const unsigned char KTX_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+const std::uint32_t KTX_ENDIANNESS = 0x04030201;
+
+// Reads only the header. Returns false for anything that is not a little endian compressed 2D KTX file
+inline bool read_ktx_header(std::istream &in, KtxHeader &header) {
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  return std::memcmp(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0 &&
+         header.endianness == KTX_ENDIANNESS && header.gl_type == 0 && header.pixel_depth == 0 &&
+         header.number_of_faces == 1 && header.number_of_array_elements == 0 &&
+         ktx_block_bytes(header.gl_internal_format) != 0;
+}
+
+inline bool read_ktx_header(const std::string &path, KtxHeader &header) {
+  std::ifstream in(path, std::ios::binary);
+  return in && read_ktx_header(in, header);
+}
+
+inline bool read_ktx(const std::string &path, KtxImage &image) {
+  std::ifstream in(path, std::ios::binary);
+  KtxHeader header;
+  if (!in || !read_ktx_header(in, header)) {
+    return false;
+  }
+  in.seekg(header.bytes_of_key_value_data, std::ios::cur);
+
+  image.internal_format = header.gl_internal_format;
+  image.base_internal_format = header.gl_base_internal_format;
+  image.levels.clear();
+
+  const std::uint32_t level_count = header.number_of_mipmap_levels > 0 ? header.number_of_mipmap_levels : 1;
+  int width = static_cast<int>(header.pixel_width);
+  int height = static_cast<int>(header.pixel_height);
+  for (std::uint32_t i = 0; i < level_count; i++) {
+    std::uint32_t image_size = 0;
+    if (!in.read(reinterpret_cast<char*>(&image_size), sizeof(image_size)) ||
+        image_size != ktx_level_bytes(image.internal_format, width, height)) {
+      return false;
+    }
+
+    KtxLevel level;
+    level.width = width;
+    level.height = height;
+    level.data.resize(image_size);
+    if (!in.read(reinterpret_cast<char*>(level.data.data()), image_size)) {
+      return false;
+    }
+    image.levels.push_back(std::move(level));
+
+    // Block sizes are multiples of 4, so levels never need padding
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+  return true;
+}
+
+inline bool write_ktx(const std::string &path, const KtxImage &image) {
+  if (image.levels.empty()) {
+    return false;
+  }
+
+  KtxHeader header = {};
+  std::memcpy(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+  header.endianness = KTX_ENDIANNESS;
+  header.gl_type_size = 1;
+  header.gl_internal_format = image.internal_format;
+  header.gl_base_internal_format = image.base_internal_format;
+  header.pixel_width = static_cast<std::uint32_t>(image.levels[0].width);
+  header.pixel_height = static_cast<std::uint32_t>(image.levels[0].height);
+  header.number_of_faces = 1;
+  header.number_of_mipmap_levels = static_cast<std::uint32_t>(image.levels.size());
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const KtxLevel &level : image.levels) {
+    const std::uint32_t image_size = static_cast<std::uint32_t>(level.data.size());
+    out.write(reinterpret_cast<const char*>(&image_size), sizeof(image_size));
+    out.write(reinterpret_cast<const char*>(level.data.data()), image_size);
+  }
+  return static_cast<bool>(out);
+}
+
+#endif /* ktx_h */
@@ -0,0 +1,328 @@
+//
+//  light_clusters.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef light_clusters_h
+#define light_clusters_h
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Local Includes
+#include "uniform_blocks.hpp"
+#include "glm/glm.hpp"
+
+// The view frustum is cut into this many clusters across, down and in depth. Depth slices grow exponentially so
+// clusters stay roughly cube shaped all the way back
+const std::uint32_t CLUSTER_COUNT_X = 16;
+const std::uint32_t CLUSTER_COUNT_Y = 9;
+const std::uint32_t CLUSTER_COUNT_Z = 24;
+const std::uint32_t CLUSTER_COUNT = CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z;
+
+// Texture units of the buffer textures the lit shader reads point lights through. Units 0 and 1 hold the
+// material maps
+const unsigned int POINT_LIGHT_TEXTURE_UNIT = 2;
+const unsigned int CLUSTER_RANGE_TEXTURE_UNIT = 3;
+const unsigned int CLUSTER_INDEX_TEXTURE_UNIT = 4;
+
+// A point light is cut off where it would add less than this to any channel
+const float LIGHT_CUTOFF = 5.0f / 256.0f;
+
+// Distance at which a light's attenuated color drops below LIGHT_CUTOFF. The shader fades every light out towards
+// its radius, so nothing past it is ever lit and clusters out of reach can safely leave the light out. A shorter
+// radius than this one works too, the light just fades sooner
+inline float get_light_radius(const PointLight &light) {
+  const glm::vec3 color = light.ambient + light.diffuse + light.specular;
+  const float brightest = std::max(color.r, std::max(color.g, color.b));
+  const float reach = brightest / LIGHT_CUTOFF - light.constant;
+  if (reach <= 0.0f) {
+    return 0.0f;
+  }
+  if (light.quadratic <= 0.0f) {
+    return light.linear > 0.0f ? reach / light.linear : std::numeric_limits<float>::max();
+  }
+  return (-light.linear + std::sqrt(light.linear * light.linear + 4.0f * light.quadratic * reach)) /
+         (2.0f * light.quadratic);
+}
+
+// Sorts point lights into the clusters of the view frustum every frame, so the fragment shader only loops over
+// the lights that can reach its cluster. Each cluster gets an offset and count into one shared index list.
+// Depth slices are split between a pool of worker threads and the calling thread
+class LightClusters {
+
+public:
+  // Ctor
+  explicit LightClusters(const std::size_t thread_count = default_thread_count())
+  : ranges_(CLUSTER_COUNT),
+    slices_(thread_count + 1) {
+    for (std::size_t i = 1; i < slices_.size(); i++) {
+      workers_.emplace_back([this, i]() { work(i); });
+    }
+  }
+
+  // Dtor
+  ~LightClusters() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  LightClusters(const LightClusters&) = delete;
+  LightClusters& operator=(const LightClusters&) = delete;
+
+  // Assigns every light to the clusters its sphere of influence touches, for a camera with the given view
+  // matrix and perspective. Radii come from the lights themselves
+  void assign(const PointLight *lights, const std::size_t light_count, const glm::mat4 &view, const float fov_y,
+              const float aspect_ratio, const float near_plane, const float far_plane) {
+    light_count_ = light_count;
+    spheres_.resize(light_count);
+
+    // No cluster can hold more than every light, so reserving that once keeps the lists from ever growing
+    // mid-frame. The index lists have no useful bound and grow with room to spare instead
+    if (light_count > reserved_lights_) {
+      for (Share &share : slices_) {
+        for (std::vector<std::uint32_t> &lights : share.cluster_lights) {
+          lights.reserve(light_count);
+        }
+      }
+      reserved_lights_ = light_count;
+    }
+    for (std::size_t i = 0; i < light_count; i++) {
+      spheres_[i] = glm::vec4(glm::vec3(view * glm::vec4(lights[i].position, 1.0f)), lights[i].radius);
+    }
+
+    // Edges of every slice, and of every column and row as a fraction of the depth
+    depth_scale_ = CLUSTER_COUNT_Z / std::log(far_plane / near_plane);
+    depth_bias_ = -depth_scale_ * std::log(near_plane);
+    for (std::uint32_t z = 0; z <= CLUSTER_COUNT_Z; z++) {
+      slice_depths_[z] = near_plane * std::pow(far_plane / near_plane, static_cast<float>(z) / CLUSTER_COUNT_Z);
+    }
+    const float tan_y = std::tan(fov_y * 0.5f);
+    const float tan_x = tan_y * aspect_ratio;
+    for (std::uint32_t x = 0; x <= CLUSTER_COUNT_X; x++) {
+      column_edges_[x] = (2.0f * x / CLUSTER_COUNT_X - 1.0f) * tan_x;
+    }
+    for (std::uint32_t y = 0; y <= CLUSTER_COUNT_Y; y++) {
+      row_edges_[y] = (2.0f * y / CLUSTER_COUNT_Y - 1.0f) * tan_y;
+    }
+
+    // Workers take their share of the slices, this thread takes the first one
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++generation_;
+      pending_ = workers_.size();
+    }
+    wake_.notify_all();
+    assign_slices(0);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    // Each share has its own index list with offsets relative to it, stitch them together in slice order
+    std::size_t total = 0;
+    for (const Share &share : slices_) {
+      total += share.indices.size();
+    }
+    reserve_with_headroom(indices_, total);
+    indices_.clear();
+    for (Share &share : slices_) {
+      const std::uint32_t base = static_cast<std::uint32_t>(indices_.size());
+      for (std::uint32_t cluster = share.first_cluster; cluster < share.last_cluster; cluster++) {
+        ranges_[cluster].x += base;
+      }
+      indices_.insert(indices_.end(), share.indices.begin(), share.indices.end());
+    }
+  }
+
+  // Offset into get_indices() and light count of every cluster, x fastest then y then depth
+  const std::vector<glm::uvec2>& get_ranges() const {
+    return ranges_;
+  }
+
+  const std::vector<std::uint32_t>& get_indices() const {
+    return indices_;
+  }
+
+  // What LightBlock needs to find a fragment's cluster
+  glm::uvec4 get_cluster_count() const {
+    return glm::uvec4(CLUSTER_COUNT_X, CLUSTER_COUNT_Y, CLUSTER_COUNT_Z, static_cast<std::uint32_t>(light_count_));
+  }
+
+  glm::vec4 get_cluster_depth() const {
+    return glm::vec4(depth_scale_, depth_bias_, 0.0f, 0.0f);
+  }
+
+  std::size_t get_thread_count() const {
+    return slices_.size();
+  }
+
+  // Leaves a core for the render thread, counting the calling thread as one of the workers
+  static std::size_t default_thread_count() {
+    const std::size_t cores = std::thread::hardware_concurrency();
+    return std::min<std::size_t>(cores > 2 ? cores - 2 : 0, CLUSTER_COUNT_Z - 1);
+  }
+
+private:
+  // One thread's run of depth slices and the light indices it found for them
+  struct Share {
+    std::uint32_t first_cluster = 0;
+    std::uint32_t last_cluster = 0;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint32_t> cluster_lights[CLUSTER_COUNT_X * CLUSTER_COUNT_Y];
+  };
+
+  // Grows a list to twice what it needs once it runs out, so a slowly rising light count does not reallocate
+  // every frame
+  static void reserve_with_headroom(std::vector<std::uint32_t> &list, const std::size_t size) {
+    if (size > list.capacity()) {
+      list.reserve(size * 2);
+    }
+  }
+
+  void work(const std::size_t share) {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [this, seen]() { return stopping_ || generation_ != seen; });
+      if (stopping_) {
+        return;
+      }
+      seen = generation_;
+
+      lock.unlock();
+      assign_slices(share);
+      lock.lock();
+
+      if (--pending_ == 0) {
+        done_.notify_one();
+      }
+    }
+  }
+
+  // Tests every light against the clusters of a run of depth slices. A light's sphere first narrows down the
+  // columns and rows it can touch in a slice, then each of those clusters is tested exactly as a box
+  void assign_slices(const std::size_t index) {
+    Share &share = slices_[index];
+    const std::uint32_t first_slice = static_cast<std::uint32_t>(CLUSTER_COUNT_Z * index / slices_.size());
+    const std::uint32_t last_slice = static_cast<std::uint32_t>(CLUSTER_COUNT_Z * (index + 1) / slices_.size());
+    const std::uint32_t slice_clusters = CLUSTER_COUNT_X * CLUSTER_COUNT_Y;
+    share.first_cluster = first_slice * slice_clusters;
+    share.last_cluster = last_slice * slice_clusters;
+    share.indices.clear();
+
+    for (std::uint32_t z = first_slice; z < last_slice; z++) {
+      const float near_depth = slice_depths_[z];
+      const float far_depth = slice_depths_[z + 1];
+
+      // Cluster sides are planes through the eye, so a column's widest extent is at one of the slice's ends
+      float column_min[CLUSTER_COUNT_X];
+      float column_max[CLUSTER_COUNT_X];
+      for (std::uint32_t x = 0; x < CLUSTER_COUNT_X; x++) {
+        column_min[x] = std::min(column_edges_[x] * near_depth, column_edges_[x] * far_depth);
+        column_max[x] = std::max(column_edges_[x + 1] * near_depth, column_edges_[x + 1] * far_depth);
+      }
+      float row_min[CLUSTER_COUNT_Y];
+      float row_max[CLUSTER_COUNT_Y];
+      for (std::uint32_t y = 0; y < CLUSTER_COUNT_Y; y++) {
+        row_min[y] = std::min(row_edges_[y] * near_depth, row_edges_[y] * far_depth);
+        row_max[y] = std::max(row_edges_[y + 1] * near_depth, row_edges_[y + 1] * far_depth);
+      }
+
+      for (std::uint32_t i = 0; i < light_count_; i++) {
+        // View space looks down -z, depths are positive
+        const glm::vec4 &sphere = spheres_[i];
+        const float depth = -sphere.z;
+        const float radius = sphere.w;
+        if (depth + radius < near_depth || depth - radius > far_depth) {
+          continue;
+        }
+        const float depth_distance = std::max(near_depth - depth, 0.0f) + std::max(depth - far_depth, 0.0f);
+        const float depth_squared = depth_distance * depth_distance;
+        const float radius_squared = radius * radius;
+
+        std::uint32_t first_column = 0;
+        while (first_column < CLUSTER_COUNT_X && column_max[first_column] < sphere.x - radius) {
+          ++first_column;
+        }
+        std::uint32_t last_column = CLUSTER_COUNT_X;
+        while (last_column > first_column && column_min[last_column - 1] > sphere.x + radius) {
+          --last_column;
+        }
+        std::uint32_t first_row = 0;
+        while (first_row < CLUSTER_COUNT_Y && row_max[first_row] < sphere.y - radius) {
+          ++first_row;
+        }
+        std::uint32_t last_row = CLUSTER_COUNT_Y;
+        while (last_row > first_row && row_min[last_row - 1] > sphere.y + radius) {
+          --last_row;
+        }
+
+        for (std::uint32_t y = first_row; y < last_row; y++) {
+          const float y_distance = std::max(row_min[y] - sphere.y, 0.0f) + std::max(sphere.y - row_max[y], 0.0f);
+          const float yz_squared = depth_squared + y_distance * y_distance;
+          if (yz_squared > radius_squared) {
+            continue;
+          }
+          for (std::uint32_t x = first_column; x < last_column; x++) {
+            const float x_distance = std::max(column_min[x] - sphere.x, 0.0f) +
+                                     std::max(sphere.x - column_max[x], 0.0f);
+            if (yz_squared + x_distance * x_distance <= radius_squared) {
+              share.cluster_lights[y * CLUSTER_COUNT_X + x].push_back(i);
+            }
+          }
+        }
+      }
+
+      for (std::uint32_t cluster = 0; cluster < slice_clusters; cluster++) {
+        std::vector<std::uint32_t> &lights = share.cluster_lights[cluster];
+        ranges_[z * slice_clusters + cluster] = glm::uvec2(static_cast<std::uint32_t>(share.indices.size()),
+                                                           static_cast<std::uint32_t>(lights.size()));
+        reserve_with_headroom(share.indices, share.indices.size() + lights.size());
+        share.indices.insert(share.indices.end(), lights.begin(), lights.end());
+        lights.clear();
+      }
+    }
+  }
+
+  std::vector<glm::uvec2> ranges_;
+  std::vector<std::uint32_t> indices_;
+  std::vector<Share> slices_;
+
+  // Inputs of the current assign(), read by every thread
+  std::vector<glm::vec4> spheres_;
+  std::size_t light_count_ = 0;
+  std::size_t reserved_lights_ = 0;
+  float slice_depths_[CLUSTER_COUNT_Z + 1] = {};
+  float column_edges_[CLUSTER_COUNT_X + 1] = {};
+  float row_edges_[CLUSTER_COUNT_Y + 1] = {};
+  float depth_scale_ = 0.0f;
+  float depth_bias_ = 0.0f;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::size_t generation_ = 0;
+  std::size_t pending_ = 0;
+  bool stopping_ = false;
+};
+
+#endif /* light_clusters_h */
@@ -0,0 +1,140 @@
+// Everything that lights a surface, shared by forward shading in shader.frag and deferred shading in
+// deferred_light.frag. The lights themselves are filled in on the CPU, see uniform_blocks.hpp and light_clusters.hpp
+#include "camera.glsl"
+
+// Light structs are laid out so every float fills the tail of the vec3 before it under std140
+struct DirLight {
+  vec3 direction;
+
+  vec3 ambient;
+  vec3 diffuse;
+  vec3 specular;
+};
+
+struct PointLight {
+  vec3 position;
+  float constant;
+
+  vec3 ambient;
+  float linear;
+  vec3 diffuse;
+  float quadratic;
+  vec3 specular;
+  float radius;
+};
+
+// Material maps sampled once per fragment and shared by every light
+struct Surface {
+  vec3 albedo;
+  vec3 specular;
+  float shininess;
+};
+
+struct SpotLight {
+  vec3 position;
+  float constant;
+  vec3 direction;
+  float linear;
+
+  vec3 ambient;
+  float quadratic;
+  vec3 diffuse;
+  float cutOff;
+  vec3 specular;
+  float outerCutOff;
+};
+
+layout (std140) uniform LightBlock {
+  DirLight dirLight;
+  SpotLight spotLight;
+  uvec4 clusterCount;
+  vec4 clusterDepth;
+};
+
+// Point lights are sorted into clusters of the view frustum on the CPU, see light_clusters.hpp. Each light is four
+// texels laid out like PointLight, each cluster an offset and count into the light index list
+uniform samplerBuffer pointLights;
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer clusterIndices;
+
+// calculates the color when using a directional light.
+vec3 CalcDirLight(DirLight light, Surface surface, vec3 normal, vec3 viewDir) {
+  vec3 lightDir = normalize(-light.direction);
+  // diffuse shading
+  float diff = max(dot(normal, lightDir), 0.0);
+  // specular shading
+  vec3 reflectDir = reflect(-lightDir, normal);
+  float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+  // combine results
+  vec3 ambient = light.ambient * surface.albedo;
+  vec3 diffuse = light.diffuse * diff * surface.albedo;
+  vec3 specular = light.specular * spec * surface.specular;
+  return (ambient + diffuse + specular);
+}
+
+// Calculates the color when using a point light.
+vec3 CalcPointLight(PointLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir) {
+  vec3 lightDir = normalize(light.position - fragPos);
+  // Diffuse shading
+  float diff = max(dot(normal, lightDir), 0.0);
+  // Specular shading
+  vec3 reflectDir = reflect(-lightDir, normal);
+  float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+  // Attenuation, faded out to nothing at the light's radius so clusters beyond it can leave the light out
+  float distance = length(light.position - fragPos);
+  float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+  float falloff = clamp(1.0 - pow(distance / light.radius, 4.0), 0.0, 1.0);
+  attenuation *= falloff * falloff;
+  // Combine results
+  vec3 ambient = light.ambient * surface.albedo;
+  vec3 diffuse = light.diffuse * diff * surface.albedo;
+  vec3 specular = light.specular * spec * surface.specular;
+  ambient *= attenuation;
+  diffuse *= attenuation;
+  specular *= attenuation;
+  return (ambient + diffuse + specular);
+}
+
+// Calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir) {
+  vec3 lightDir = normalize(light.position - fragPos);
+  // Diffuse shading
+  float diff = max(dot(normal, lightDir), 0.0);
+  // Specular shading
+  vec3 reflectDir = reflect(-lightDir, normal);
+  float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+  // Attenuation
+  float distance = length(light.position - fragPos);
+  float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+  // Spotlight intensity
+  float theta = dot(lightDir, normalize(-light.direction));
+  float epsilon = light.cutOff - light.outerCutOff;
+  float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+  // Combine results
+  vec3 ambient = light.ambient * surface.albedo;
+  vec3 diffuse = light.diffuse * diff * surface.albedo;
+  vec3 specular = light.specular * spec * surface.specular;
+  ambient *= attenuation * intensity;
+  diffuse *= attenuation * intensity;
+  specular *= attenuation * intensity;
+  return (ambient + diffuse + specular);
+}
+
+// Reads a point light back out of the buffer texture
+PointLight FetchPointLight(int index) {
+  vec4 position = texelFetch(pointLights, index * 4);
+  vec4 ambient = texelFetch(pointLights, index * 4 + 1);
+  vec4 diffuse = texelFetch(pointLights, index * 4 + 2);
+  vec4 specular = texelFetch(pointLights, index * 4 + 3);
+  return PointLight(position.xyz, position.w, ambient.xyz, ambient.w, diffuse.xyz, diffuse.w, specular.xyz,
+                    specular.w);
+}
+
+// Cluster a world space position falls in. Columns and rows split the screen evenly, depth slices are
+// exponential in view space depth, which is the clip space w of a perspective projection
+uint FindCluster(vec3 fragPos) {
+  vec4 clip = projection * view * vec4(fragPos, 1.0);
+  vec2 cell = clamp((clip.xy / clip.w * 0.5 + 0.5) * vec2(clusterCount.xy), vec2(0.0), vec2(clusterCount.xy) - 1.0);
+  float slice = clamp(log(clip.w) * clusterDepth.x + clusterDepth.y, 0.0, float(clusterCount.z) - 1.0);
+  return uint(cell.x) + clusterCount.x * (uint(cell.y) + clusterCount.y * uint(slice));
+}
@@ -7,18 +7,63 @@
 //
 
 // Library Includes
+#define GL_LOADER_IMPLEMENTATION
+#include "gl_loader.hpp"
+#ifndef OPENGL_NO_GLFW
+#define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
-#include <OpenGL/gl3.h>
+#else
+struct GLFWwindow;
+#endif
 
 // System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <math.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
 
 // Local Includes
+#define ALLOCATION_COUNTER_IMPLEMENTATION
+#include "allocation_counter.hpp"
+#undef ALLOCATION_COUNTER_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
-#include "camera.hpp"
 #include "stb_image.h"
+#undef STB_IMAGE_IMPLEMENTATION
+#include "benchmark.hpp"
+#include "camera.hpp"
+#include "draw_commands.hpp"
+#include "dynamic_ring_buffer.hpp"
+#include "frame_arena.hpp"
+#include "framebuffer.hpp"
+#include "frustum.hpp"
+#include "gbuffer.hpp"
+#include "gl_state_cache.hpp"
+#include "headless_context.hpp"
+#include "instance_buffer.hpp"
+#include "light_clusters.hpp"
+#include "mesh.hpp"
+#include "mesh_pool.hpp"
+#include "mesh_optimizer.hpp"
+#include "model_loader.hpp"
+#include "normal_matrix.hpp"
+#include "profiler.hpp"
+#include "render_queue.hpp"
+#include "render_stats.hpp"
+#include "scene.hpp"
 #include "shader.hpp"
+#include "shader_library.hpp"
+#include "shapes.hpp"
+#include "texture_buffer.hpp"
+#include "texture_cache.hpp"
+#include "uniform_blocks.hpp"
+#include "uniform_buffer.hpp"
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
@@ -27,6 +72,9 @@
 const unsigned int WINDOW_WIDTH = 800;
 const unsigned int WINDOW_HEIGHT = 600;
 
+// Frames rendered before a benchmark starts recording, so shader compiles and first uploads are left out
+const std::size_t BENCHMARK_WARMUP_FRAMES = 10;
+
 // Timing variables
 float delta_time = 0.0f;
 float last_frame = 0.0f;
@@ -37,114 +85,417 @@ float last_x = 800.0f / 2.0;
 float last_y = 600.0 / 2.0;
 bool first_mouse = true;
 
+// Set by a mouse click, the next frame picks whatever is under the crosshair
+bool pick_requested = false;
+
 // Lighting Variables
 glm::vec3 light_position(1.2f, 1.0f, 2.0f);
 
+// G switches between forward and deferred shading while running
+bool deferred_shading = false;
+
+// F switches the flashlight, the spotlight following the camera, off and on
+bool flashlight = true;
+
+// What the material field of the sort keys stands for. The program field holds a variant from the shader library
+const std::uint32_t MATERIAL_CONTAINER = 0;
+const std::uint32_t MATERIAL_NONE = 1;
+
+// Distinct shapes --meshes can make before they repeat
+const std::size_t MAX_MESH_COUNT = 4096;
+
+#ifndef OPENGL_NO_GLFW
 // Lambda Graveyard
 void key_callback(GLFWwindow *window, const int key, const int scancode,
                   const int action, const int mods);
 
 void mouse_callback(GLFWwindow *window, const double x_position, const double y_position);
 
+void mouse_button_callback(GLFWwindow *window, const int button, const int action, const int mods);
+
 void scroll_callback(GLFWwindow *window, const double x_offset, const double y_offset);
 
 // Kill function
 void kill_glfw() {
   glfwTerminate();
 }
+#endif
+
+// Seconds since the first call. Works with or without a window
+double get_time() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Command line options
+struct Options {
+  std::size_t cube_count = 10;
+  bool inverse_normals = false;
+  
+  // Render offscreen into a framebuffer instead of a window. Stops after frame_limit frames
+  bool headless = false;
+  std::size_t frame_limit = 0;
+  std::string output_path;
+  
+  // Drive the camera along a scripted path for frame_limit frames and report frame time percentiles
+  bool benchmark = false;
+  CameraPathType camera_path = ORBIT;
+  std::string trace_path;
+  
+  // Chrome trace of the profiler's CPU and GPU scopes
+  std::string profile_path;
+  
+  // OBJ, glTF or GLB file drawn in place of the containers
+  std::string model_path;
+  
+  // Only instances inside the view frustum are uploaded and drawn
+  bool cull = true;
+  
+  // Spin the hand-placed containers, which keeps the scene hierarchy refitting every frame
+  bool animate = false;
+  
+  // Point lights, the first four hand-placed and the rest scattered through the scene
+  std::size_t light_count = 4;
+  
+  // Start with deferred shading instead of forward
+  bool deferred = false;
+  
+  // Distinct meshes the containers cycle through, the cube or model first and then procedural spheres
+  std::size_t mesh_count = 1;
+  
+  // Draw every run of batches with one glMultiDrawElementsIndirect call when the context has it
+  bool multi_draw = true;
+  
+  // Stream per-frame data through a persistently mapped buffer when the context has glBufferStorage
+  bool persistent_map = true;
+  
+  // Load linked programs from binaries cached by earlier runs instead of compiling them every launch
+  bool program_cache = true;
+  
+  // Start with the flashlight switched on, --no-flashlight turns it off
+  bool flashlight = true;
+  
+  // Rebuild programs whose files change while running
+  bool hot_reload = true;
+};
 
-// Texture function
-unsigned int load_texture(char const *path) {
-  unsigned int textureID;
-  glGenTextures(1, &textureID);
+Options parse_options(const int argc, const char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--cubes") == 0 && i + 1 < argc) {
+      options.cube_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--inverse-normals") == 0) {
+      options.inverse_normals = true;
+    }
+    else if (std::strcmp(argv[i], "--headless") == 0) {
+      options.headless = true;
+    }
+    else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      options.frame_limit = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      options.output_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--benchmark") == 0 && i + 1 < argc) {
+      options.benchmark = true;
+      options.frame_limit = std::strtoul(argv[++i], nullptr, 10) + BENCHMARK_WARMUP_FRAMES;
+    }
+    else if (std::strcmp(argv[i], "--camera-path") == 0 && i + 1 < argc) {
+      if (!CameraPath::parse(argv[++i], options.camera_path)) {
+        std::cerr << "Unknown camera path: " << argv[i] << "\n";
+      }
+    }
+    else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      options.trace_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+      options.profile_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+      options.model_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "--no-cull") == 0) {
+      options.cull = false;
+    }
+    else if (std::strcmp(argv[i], "--animate") == 0) {
+      options.animate = true;
+    }
+    else if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+      options.light_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--deferred") == 0) {
+      options.deferred = true;
+    }
+    else if (std::strcmp(argv[i], "--meshes") == 0 && i + 1 < argc) {
+      options.mesh_count = std::max<std::size_t>(1, std::min(std::strtoul(argv[++i], nullptr, 10), MAX_MESH_COUNT));
+    }
+    else if (std::strcmp(argv[i], "--no-multi-draw") == 0) {
+      options.multi_draw = false;
+    }
+    else if (std::strcmp(argv[i], "--no-persistent-map") == 0) {
+      options.persistent_map = false;
+    }
+    else if (std::strcmp(argv[i], "--no-program-cache") == 0) {
+      options.program_cache = false;
+    }
+    else if (std::strcmp(argv[i], "--no-flashlight") == 0) {
+      options.flashlight = false;
+    }
+    else if (std::strcmp(argv[i], "--no-hot-reload") == 0) {
+      options.hot_reload = false;
+    }
+    else {
+      std::cerr << "Unknown option: " << argv[i] << "\n";
+    }
+  }
+  
+  // Nobody can close a headless run, so it always needs a frame limit
+  if (options.headless && options.frame_limit == 0) {
+    options.frame_limit = 300;
+  }
+  return options;
+}
 
-  int width, height, nrComponents;
-  unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
-  if (data) {
-    GLenum format;
-    if (nrComponents == 1) {
-      format = GL_RED;
+// Builds the instance data of every container. The first ones keep their hand-placed positions and any extra
+// cubes fill a grid further back, so the instanced path can be pushed to large counts
+std::vector<InstanceData> build_cube_instances(const glm::vec3 *positions, const std::size_t position_count,
+                                               const std::size_t count) {
+  std::vector<InstanceData> instances(count);
+  const std::size_t side = static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+  
+  for (std::size_t i = 0; i < count; i++) {
+    glm::vec3 position;
+    if (i < position_count) {
+      position = positions[i];
     }
-    else if (nrComponents == 3) {
-      format = GL_RGB;
+    else {
+      const std::size_t cell = i - position_count;
+      position = glm::vec3(static_cast<float>(cell % side) * 2.0f - static_cast<float>(side),
+                           static_cast<float>(cell / side % side) * 2.0f - static_cast<float>(side),
+                           -20.0f - static_cast<float>(cell / (side * side)) * 2.0f);
     }
-    else if (nrComponents == 4) {
-      format = GL_RGBA;
+    
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, position);
+    const float angle = 20.0f * i;
+    instances[i].model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+  }
+  
+  compute_normal_matrices(instances.data(), instances.size());
+  return instances;
+}
+
+// Builds every point light. The first ones keep their hand-placed positions and white light that reaches across
+// the scene. Any extra lights are scattered through the containers with a random color and a short reach, the
+// way a scene with hundreds of lights would be set up
+std::vector<PointLight> build_point_lights(const glm::vec3 *positions, const std::size_t position_count,
+                                           const std::size_t count) {
+  std::vector<PointLight> lights(count);
+  std::mt19937 random(1);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  for (std::size_t i = 0; i < count; i++) {
+    PointLight &light = lights[i];
+    light.constant = 1.0f;
+    if (i < position_count) {
+      light.position = positions[i];
+      light.ambient = glm::vec3(0.05f, 0.05f, 0.05f);
+      light.diffuse = glm::vec3(0.8f, 0.8f, 0.8f);
+      light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+      light.linear = 0.09f;
+      light.quadratic = 0.032f;
+    }
+    else {
+      light.position = glm::vec3(unit(random) * 16.0f - 8.0f, unit(random) * 11.0f - 5.0f,
+                                 unit(random) * -21.0f + 3.0f);
+      const glm::vec3 color(unit(random), unit(random), unit(random));
+      light.ambient = glm::vec3(0.0f);
+      light.diffuse = color * 0.8f;
+      light.specular = color;
+      light.linear = 0.7f;
+      light.quadratic = 1.8f;
     }
+    
+    // Scattered lights are cut off well before they fade on their own, or each would reach a good part of the scene
+    light.radius = i < position_count ? get_light_radius(light) : 1.5f + unit(random) * 1.5f;
+  }
+  return lights;
+}
 
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+// World space bounds of every instance of a mesh, whose vertices span the unit box before the model matrix
+BoxArray build_instance_bounds(const std::vector<InstanceData> &instances) {
+  BoxArray bounds;
+  bounds.reserve(instances.size());
+  for (const InstanceData &instance : instances) {
+    bounds.push_back(instance.model, glm::vec3(0.0f), glm::vec3(1.0f));
+  }
+  return bounds;
+}
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Lists every instance in indices when there is no frustum to cull against, and counts the visible ones in the
+// render stats
+void finish_visible(const Frustum *frustum, const std::size_t count, FrameVector<std::uint32_t> &indices) {
+  if (frustum == nullptr) {
+    indices.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+      indices[i] = static_cast<std::uint32_t>(i);
+    }
+  }
+  render_stats().drawn_objects += indices.size();
+  render_stats().culled_objects += count - indices.size();
+}
 
-    stbi_image_free(data);
+// Lists the instances whose bounds intersect the frustum in indices. Without culling every instance is listed
+void gather_visible(const Frustum *frustum, const BoxArray &bounds, const std::size_t count,
+                    FrameVector<std::uint32_t> &indices) {
+  if (frustum != nullptr) {
+    indices.resize(count);
+    indices.resize(cull_boxes(*frustum, bounds, indices.data()));
   }
-  else {
-    std::cerr << "Texture failed to load at path: " << path << "\n";
-    stbi_image_free(data);
+  finish_visible(frustum, count, indices);
+}
+
+// Same for instances indexed by a scene, whose object ids are the instance indices
+void gather_visible(const Frustum *frustum, const Scene &scene, const std::size_t count,
+                    FrameVector<std::uint32_t> &indices) {
+  if (frustum != nullptr) {
+    indices.clear();
+    scene.cull(*frustum, indices);
   }
+  finish_visible(frustum, count, indices);
+}
 
-  return textureID;
+// Textures a material binds to units 0 and 1. A texture of 0 leaves its unit alone
+struct DrawMaterial {
+  unsigned int diffuse = 0;
+  unsigned int specular = 0;
+};
+
+// Queues the listed instances as draws of one program and material, each with the pool mesh meshes gives it.
+// Depth is the distance of the mesh's center along the view direction, the center being where the dequantized
+// unit cube puts it. Payloads index queued
+void queue_instances(const std::vector<InstanceData> &instances, const FrameVector<std::uint32_t> &indices,
+                     const std::vector<std::uint32_t> &meshes, const RenderPass pass, const std::uint32_t program,
+                     const std::uint32_t material, const glm::vec3 &eye, const glm::vec3 &front,
+                     FrameVector<InstanceData> &queued, RenderQueue &queue) {
+  for (const std::uint32_t index : indices) {
+    const InstanceData &instance = instances[index];
+    const glm::vec3 center(instance.model * glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
+    queue.push(make_sort_key(pass, program, material, meshes[index], glm::dot(center - eye, front)),
+               static_cast<std::uint32_t>(queued.size()));
+    queued.push_back(instance);
+  }
 }
 
-// Main function
-int main(int argc, const char *argv[]) {
-  
-  // Callback City
-  const auto error_callback = [](int error, const char *description) {
-    std::cerr << "Error: " << description << "\n";
-  };
-  
-  const auto frame_buffer_size_callback = [](GLFWwindow *window, const int width, const int height) {
-    glViewport(0, 0, width, height);
-  };
-  
-  // Initialize GLFW
-  if (!glfwInit()) {
-    std::cout << "GLFW failed to initialize! Quitting program...\n";
-    return -1;
+// Draws the batches of one pass in sorted order, expecting one command per batch in commands. Batches that only
+// differ in mesh go out together, and program and texture switches go through the state cache, so they only
+// reach the driver where consecutive runs differ
+void submit_pass(const RenderQueue &queue, const RenderPass pass, ShaderLibrary &programs,
+                 const DrawMaterial *materials, DrawCommandBuffer &commands, const MeshPool &pool) {
+  const std::vector<RenderBatch> &batches = queue.get_batches();
+  std::size_t first = 0;
+  while (first < batches.size()) {
+    const std::uint64_t key = batches[first].key;
+    std::size_t last = first + 1;
+    while (last < batches.size() && batches[last].key >> SORT_KEY_MATERIAL_SHIFT == key >> SORT_KEY_MATERIAL_SHIFT) {
+      ++last;
+    }
+    
+    if (get_key_pass(key) == pass) {
+      programs.get(get_key_program(key)).use();
+      const DrawMaterial &material = materials[get_key_material(key)];
+      if (material.diffuse != 0) {
+        gl_state().bind_texture(0, GL_TEXTURE_2D, material.diffuse);
+      }
+      if (material.specular != 0) {
+        gl_state().bind_texture(1, GL_TEXTURE_2D, material.specular);
+      }
+      commands.draw(static_cast<std::uint32_t>(first), static_cast<std::uint32_t>(last - first), pool, 3);
+    }
+    first = last;
   }
+}
+
+// Renders the scene until the window closes or the frame limit is reached. Expects a current context with
+// every GL function loaded. Without a window, frames go into an offscreen framebuffer
+int run(const Options &options, GLFWwindow *window) {
   
-  // Setup windows
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  // Whatever the window system did to the context before now is unknown to the cache
+  gl_state().invalidate();
   
-  GLFWwindow *window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "My Window", nullptr, nullptr);
+  // Enable Z-buffer
+  gl_state().set_enabled(GL_DEPTH_TEST, true);
+  gl_state().depth_func(GL_LESS);
   
-  if (window == nullptr) {
-    std::cerr << "Failed to create GLFW window\n";
-    kill_glfw();
-    return -1;
+  std::unique_ptr<Framebuffer> offscreen;
+  if (window == nullptr || options.headless) {
+    offscreen.reset(new Framebuffer(WINDOW_WIDTH, WINDOW_HEIGHT));
+    offscreen->bind();
   }
   
-  glfwMakeContextCurrent(window);
-  
-  // Set Callbacks
-  glfwSetErrorCallback(error_callback);
-  glfwSetKeyCallback(window, key_callback);
-  glfwSetCursorPosCallback(window, mouse_callback);
-  glfwSetScrollCallback(window, scroll_callback);
+  // Setup shader class. Every program comes in variants for the features that change between draws, and every
+  // variant this run can draw with starts building here. They are only waited on right before the first frame,
+  // so on drivers that compile in the background that happens while the scene is being built
+  program_cache().enabled = options.program_cache;
+  const char *const lit_vertex = options.inverse_normals ? "shader_inverse.vert" : "shader.vert";
+  ShaderLibrary shader_library;
   
-  int window_width, window_height;
-  glfwGetFramebufferSize(window, &window_width, &window_height);
-  glViewport(0, 0, window_width, window_height);
-  glfwSetFramebufferSizeCallback(window, frame_buffer_size_callback);
-
-  // Enable Z-buffer
-  glEnable(GL_DEPTH_TEST);
+  // Camera and light data live in uniform buffers shared by every program. Samplers and blocks are set up on
+  // each variant once it is built, which includes rebuilds after its files change
+  const ShaderSetup lit_setup = [](const std::uint32_t, Shader &shader) {
+    shader.use();
+    shader.set_int("material.diffuse", 0);
+    shader.set_int("material.specular", 1);
+    shader.set_int("pointLights", POINT_LIGHT_TEXTURE_UNIT);
+    shader.set_int("clusterRanges", CLUSTER_RANGE_TEXTURE_UNIT);
+    shader.set_int("clusterIndices", CLUSTER_INDEX_TEXTURE_UNIT);
+    shader.set_float("material.shininess", 32.0f);
+    shader.bind_uniform_block("CameraBlock", CAMERA_BLOCK_BINDING);
+    shader.bind_uniform_block("LightBlock", LIGHT_BLOCK_BINDING);
+  };
+  const ShaderSetup lamp_setup = [](const std::uint32_t, Shader &shader) {
+    shader.bind_uniform_block("CameraBlock", CAMERA_BLOCK_BINDING);
+    shader.bind_uniform_block("LightBlock", LIGHT_BLOCK_BINDING);
+  };
+  const std::uint32_t lit_program = shader_library.add(lit_vertex, "shader.frag", SHADER_FEATURE_POINT_LIGHTS |
+                                                       SHADER_FEATURE_SPOT_LIGHT | SHADER_FEATURE_SPECULAR_MAP,
+                                                       lit_setup);
+  const std::uint32_t lamp_program = shader_library.add("light_shader.vert", "light_shader.frag", 0, lamp_setup);
   
-  // Tell GLFW to capture our mouse
-  glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+  // Deferred shading writes the lit objects' surfaces out in a geometry pass and lights every pixel once after.
+  // Each lighting variant has a location of its own for the matrix, kept by variant
+  std::vector<UniformHandle<glm::mat4>> inverse_view_projection;
+  const ShaderSetup gbuffer_setup = [](const std::uint32_t, Shader &shader) {
+    shader.use();
+    shader.set_int("material.diffuse", 0);
+    shader.set_int("material.specular", 1);
+    shader.set_float("material.shininess", 32.0f);
+    shader.bind_uniform_block("CameraBlock", CAMERA_BLOCK_BINDING);
+  };
+  const ShaderSetup deferred_setup = [&inverse_view_projection](const std::uint32_t variant, Shader &shader) {
+    shader.use();
+    shader.set_int("gAlbedo", GBUFFER_ALBEDO_TEXTURE_UNIT);
+    shader.set_int("gNormal", GBUFFER_NORMAL_TEXTURE_UNIT);
+    shader.set_int("gSpecular", GBUFFER_SPECULAR_TEXTURE_UNIT);
+    shader.set_int("gDepth", GBUFFER_DEPTH_TEXTURE_UNIT);
+    shader.set_int("pointLights", POINT_LIGHT_TEXTURE_UNIT);
+    shader.set_int("clusterRanges", CLUSTER_RANGE_TEXTURE_UNIT);
+    shader.set_int("clusterIndices", CLUSTER_INDEX_TEXTURE_UNIT);
+    shader.bind_uniform_block("CameraBlock", CAMERA_BLOCK_BINDING);
+    shader.bind_uniform_block("LightBlock", LIGHT_BLOCK_BINDING);
+    inverse_view_projection[variant] = shader.get_uniform<glm::mat4>("inverseViewProjection");
+  };
+  const std::uint32_t gbuffer_program = shader_library.add(lit_vertex, "gbuffer.frag", SHADER_FEATURE_SPECULAR_MAP,
+                                                           gbuffer_setup);
+  const std::uint32_t deferred_program = shader_library.add("deferred_light.vert", "deferred_light.frag",
+                                                            SHADER_FEATURE_POINT_LIGHTS | SHADER_FEATURE_SPOT_LIGHT,
+                                                            deferred_setup);
   
-  // Setup shader class
-  Shader shader("shader.vert", "shader.frag");
-  Shader lighting_shader("light_shader.vert", "light_shader.frag");
+  // Point lights are there for the whole run or not at all, the flashlight and specular maps come and go
+  const std::uint32_t scene_features = options.light_count > 0 ? SHADER_FEATURE_POINT_LIGHTS : 0;
+  shader_library.require(scene_features, SHADER_FEATURE_SPOT_LIGHT | SHADER_FEATURE_SPECULAR_MAP);
+  inverse_view_projection.resize(shader_library.get_variant_count());
+  shader_library.compile();
   
   // Array of vertices
   float vertices[] = {
@@ -214,186 +565,660 @@ int main(int argc, const char *argv[]) {
     glm::vec3( 0.0f,  0.0f, -3.0f)
   };
   
-  // Setup structures
-  GLuint VAO, VBO;
-  glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-  glBindVertexArray(VAO);
+  // Setup structures. The corners shared by the two triangles of each face are merged into one indexed mesh.
+  // Every mesh goes into one pool, drawn from a single vertex array
+  const std::size_t vertex_count = sizeof(vertices) / sizeof(vertices[0]) / 8;
+  const MeshData cube_data = build_optimized_mesh(reinterpret_cast<const Vertex*>(vertices), vertex_count,
+                                                  &std::cout);
+  const PackedMesh cube_packed = pack_mesh(cube_data);
+  MeshPool mesh_pool;
+  const std::uint32_t cube_mesh = mesh_pool.add(cube_packed.get_view());
+  std::cout << "Cube mesh: " << cube_packed.vertices.size() * sizeof(PackedVertex) + cube_packed.indices.size()
+            << " bytes on the GPU, " << vertex_count * sizeof(Vertex) << " as unindexed floats\n";
+  
+  // A loaded model takes the place of the containers, the light cubes stay cubes. With --meshes the containers
+  // cycle through it and procedural spheres of every ring, segment and twist count.
+  // Picking tests the triangles of a CPU copy of each mesh, indexed once here in the same order as the pool
+  std::vector<PickMesh> pick_meshes;
+  pick_meshes.push_back(PickMesh::from_packed(cube_packed.get_view()));
+  std::vector<std::uint32_t> lit_meshes(1, cube_mesh);
+  {
+    // The pool reads every mesh from where it lies, the mapped cache included, so all of them stay put until
+    // it has uploaded
+    LoadedModel model;
+    if (!options.model_path.empty() && load_model(options.model_path, model, &std::cout)) {
+      lit_meshes[0] = mesh_pool.add(model.view);
+      std::cout << "Model mesh: " << model.view.vertex_count * sizeof(PackedVertex) +
+                   model.view.index_count * get_index_size(model.view.index_type) << " bytes\n";
+      
+      const double index_start = get_time();
+      pick_meshes.push_back(PickMesh::from_packed(model.view));
+      std::cout << "Model pick hierarchy: " << pick_meshes.back().triangles.get_nodes().size() << " nodes built in "
+                << (get_time() - index_start) * 1000.0 << " ms\n";
+    }
+    std::vector<PackedMesh> spheres;
+    spheres.reserve(options.mesh_count);
+    for (std::size_t variant = 0; variant + 1 < options.mesh_count; variant++) {
+      const std::vector<Vertex> sphere = build_sphere(2 + variant % 16, 3 + variant / 16 % 16,
+                                                      static_cast<float>(variant / 256 % 16) * 0.05f);
+      spheres.push_back(pack_mesh(build_optimized_mesh(sphere.data(), sphere.size())));
+      lit_meshes.push_back(mesh_pool.add(spheres.back().get_view()));
+      pick_meshes.push_back(PickMesh::from_packed(spheres.back().get_view()));
+    }
+    const double upload_start = get_time();
+    mesh_pool.upload();
+    glFinish();
+    std::cout << "Mesh pool: " << mesh_pool.size() << " meshes, " << mesh_pool.get_bytes() << " bytes uploaded in "
+              << (get_time() - upload_start) * 1000.0 << " ms\n";
+  }
   
-  // Position attribute
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-  glEnableVertexAttribArray(0);
+  // Vertex positions are stored quantized to the mesh bounds, mapping them back rides along in the model matrix.
+  // Lit meshes are also scaled down to the size of a container, which leaves the cube as it is
+  std::vector<glm::mat4> mesh_fits(mesh_pool.size());
+  for (std::uint32_t mesh = 0; mesh < mesh_pool.size(); mesh++) {
+    mesh_fits[mesh] = mesh_pool.get_dequantize_matrix(mesh);
+  }
+  for (const std::uint32_t mesh : lit_meshes) {
+    mesh_fits[mesh] = get_unit_fit_matrix(mesh_pool.get_mesh(mesh).bounds) * mesh_fits[mesh];
+  }
   
-  // Normal attribute
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  // Per-instance model and normal matrices, at attribute locations 3 to 9 in both programs
+  std::vector<InstanceData> cube_models = build_cube_instances(cube_positions, sizeof(cube_positions) /
+                                                               sizeof(cube_positions[0]), options.cube_count);
+  std::vector<std::uint32_t> cube_meshes(cube_models.size());
+  for (std::size_t i = 0; i < cube_models.size(); i++) {
+    cube_meshes[i] = lit_meshes[i % lit_meshes.size()];
+  }
+  const std::size_t hand_placed_lights = sizeof(point_light_positions) / sizeof(point_light_positions[0]);
+  const std::vector<PointLight> point_lights = build_point_lights(point_light_positions, hand_placed_lights,
+                                                                  options.light_count);
+  std::vector<InstanceData> light_models(point_lights.size());
+  for (std::size_t i = 0; i < point_lights.size(); i++) {
+    light_models[i].model = glm::translate(glm::mat4(1.0f), point_lights[i].position);
+    light_models[i].model = glm::scale(light_models[i].model, glm::vec3(i < hand_placed_lights ? 0.2f : 0.05f));
+  }
+  compute_normal_matrices(light_models.data(), light_models.size());
+  const std::vector<std::uint32_t> light_meshes(light_models.size(), cube_mesh);
   
-  // Texture attribute
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-  glEnableVertexAttribArray(2);
-
-  GLuint light_vao;
-  glGenVertexArrays(1, &light_vao);
-  glBindVertexArray(light_vao);
-
-  // We only need to bind to the VBO (to link it with glVertexAttribPointer), no need to fill it; the VBO's data already contains all we need (it's already bound, but we do it again for educational purposes)
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-  glEnableVertexAttribArray(0);
+  const std::size_t animated_count = options.animate ? std::min(cube_models.size(), sizeof(cube_positions) /
+                                                                sizeof(cube_positions[0])) : 0;
+  std::vector<glm::mat4> animated_placements(animated_count);
+  for (std::size_t i = 0; i < animated_count; i++) {
+    animated_placements[i] = cube_models[i].model;
+  }
+  if (options.inverse_normals) {
+    copy_placement_matrices(cube_models.data(), cube_models.size());
+  }
+  for (std::size_t i = 0; i < cube_models.size(); i++) {
+    cube_models[i].model = cube_models[i].model * mesh_fits[cube_meshes[i]];
+  }
+  for (std::size_t i = 0; i < light_models.size(); i++) {
+    light_models[i].model = light_models[i].model * mesh_fits[light_meshes[i]];
+  }
+  
+  // Every queued instance is copied into the frame's ring segment in sorted order, and every batch of the queue
+  // becomes one indirect draw command reading its range. The instance buffer only takes over if the ring is full
+  InstanceBuffer overflow_instances;
+  DrawCommandBuffer draw_commands(options.multi_draw);
+  std::cout << "Draw commands: " << (draw_commands.is_multi_draw() ? "one multi-draw indirect call per run"
+                                                                   : "one draw call per command") << "\n";
+  const std::size_t max_instances = cube_models.size() + light_models.size();
+  RenderQueue render_queue;
+  render_queue.reserve(max_instances);
+  
+  // Lists that only live for a frame, the visible instances and the queued and sorted instance data, are carved
+  // out of an arena that is reset when the frame ends
+  FrameArena frame_arena(max_instances * 2 * (sizeof(InstanceData) + sizeof(std::uint32_t)) +
+                         4 * FRAME_ARENA_ALIGNMENT);
+  
+  // The containers are indexed by a scene hierarchy that is refit when they move. The few lights are culled
+  // as a flat array. Survivors of culling are gathered every frame
+  Scene scene;
+  for (std::size_t i = 0; i < cube_models.size(); i++) {
+    scene.add(cube_models[i].model, &pick_meshes[cube_meshes[i]]);
+  }
+  const double scene_start = get_time();
+  scene.build();
+  std::cout << "Scene hierarchy: " << scene.get_hierarchy().get_nodes().size() << " nodes, depth "
+            << scene.get_hierarchy().get_depth() << ", built in " << (get_time() - scene_start) * 1000.0 << " ms\n";
+  const BoxArray light_bounds = build_instance_bounds(light_models);
+  float animation_time = 0.0f;
+  std::size_t drawn_objects = 0;
+  std::size_t culled_objects = 0;
+  std::size_t state_calls = 0;
+  std::size_t skipped_state_calls = 0;
+  
+  // Steady state frames are expected to leave the heap alone, the first one that does not is reported
+  std::size_t heap_allocations = 0;
+  std::size_t allocating_frames = 0;
+  
+  const std::size_t background_builds = shader_library.finish();
+  const ProgramCacheStats &program_stats = program_cache();
+  const char *const start_kind = program_stats.compiled == 0 ? "warm" :
+                                 program_stats.loaded == 0 ? "cold" : "partly warm";
+  std::cout << "Programs: " << shader_library.get_variant_count() << " variants of "
+            << shader_library.get_program_count() << " programs ready in " << program_stats.seconds * 1000.0
+            << " ms, " << start_kind << " start with " << program_stats.loaded << " loaded from binaries and "
+            << program_stats.compiled << " compiled";
+  if (program_stats.rejected > 0) {
+    std::cout << ", " << program_stats.rejected << " binaries rejected by the driver";
+  }
+  if (shader_library.is_parallel()) {
+    std::cout << ", " << background_builds - program_stats.loaded << " compiled in the background";
+  }
+  std::cout << "\n";
+  
+  // Edits to any file a program is built from are picked up while running
+  if (options.hot_reload) {
+    shader_library.watch();
+  }
+  
+  // The G-buffer is only allocated once deferred shading is first used, and follows the viewport's size. The
+  // lighting pass draws a single triangle, which still needs a vertex array bound
+  std::unique_ptr<GBuffer> gbuffer;
+  unsigned int screen_vao = 0;
+  glGenVertexArrays(1, &screen_vao);
+  deferred_shading = options.deferred;
+  flashlight = options.flashlight;
+  DrawMaterial draw_materials[2];
+  
+  UniformBuffer<CameraBlock> camera_ubo(CAMERA_BLOCK_BINDING);
+  UniformBuffer<LightBlock> light_ubo(LIGHT_BLOCK_BINDING);
+  
+  // Everything rewritten every frame, the uniform blocks, instances and draw commands, streams through one ring.
+  // A segment fits all of them at their largest
+  DynamicRingBuffer frame_ring(align_up(sizeof(CameraBlock), RING_MAX_ALIGNMENT) +
+                               align_up(sizeof(LightBlock), RING_MAX_ALIGNMENT) +
+                               align_up(max_instances * sizeof(InstanceData), RING_MAX_ALIGNMENT) +
+                               max_instances * sizeof(DrawElementsIndirectCommand), options.persistent_map);
+  std::cout << "Frame ring: " << frame_ring.get_segment_count() << " x " << frame_ring.get_segment_bytes() / 1024
+            << " KB segments, " << (frame_ring.is_persistent() ? "persistently mapped" : "orphaned every frame")
+            << "\n";
+  
+  // Only the spotlight follows the camera, everything else is set once here
+  LightBlock lights = {};
+  lights.dir_light.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
+  lights.dir_light.ambient = glm::vec3(0.05f, 0.05f, 0.05f);
+  lights.dir_light.diffuse = glm::vec3(0.4f, 0.4f, 0.4f);
+  lights.dir_light.specular = glm::vec3(0.5f, 0.5f, 0.5f);
+  
+  lights.spot_light.ambient = glm::vec3(0.0f, 0.0f, 0.0f);
+  lights.spot_light.diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+  lights.spot_light.specular = glm::vec3(1.0f, 1.0f, 1.0f);
+  lights.spot_light.constant = 1.0f;
+  lights.spot_light.linear = 0.09f;
+  lights.spot_light.quadratic = 0.032f;
+  lights.spot_light.cut_off = glm::cos(glm::radians(12.5f));
+  lights.spot_light.outer_cut_off = glm::cos(glm::radians(15.0f));
   
-  shader.use();
+  // Point lights never move, their buffer is filled once. Which of them reach which cluster is worked out every
+  // frame as the camera moves
+  TextureBuffer point_light_buffer(GL_RGBA32F);
+  point_light_buffer.upload(point_lights.data(), point_lights.size() * sizeof(PointLight));
+  TextureBuffer cluster_range_buffer(GL_RG32UI);
+  TextureBuffer cluster_index_buffer(GL_R32UI);
+  const std::size_t max_cluster_indices = TextureBuffer::get_max_texels();
+  LightClusters light_clusters;
+  std::size_t cluster_indices = 0;
   
-  shader.set_int("material.diffuse", 0);
-  shader.set_int("material.specular", 1);
+  std::size_t uniform_lookups = 0;
+  std::size_t frame_count = 0;
+  double start_time = get_time();
+  
+  // Benchmark state
+  const std::size_t benchmark_frames = options.benchmark ? options.frame_limit - BENCHMARK_WARMUP_FRAMES : 0;
+  const CameraPath camera_path(options.camera_path, benchmark_frames);
+  BenchmarkRecorder recorder(benchmark_frames);
+  GpuFrameTimer gpu_timer;
+  const auto record_gpu_time = [&recorder](const std::size_t frame, const double gpu_ms) {
+    recorder.set_gpu_time(frame, gpu_ms);
+  };
+  
+  // Per-pass timings, always on. Events are only kept around when a trace was asked for
+  Profiler profiler(!options.profile_path.empty());
+  
+  // Textures are decoded off the render thread and stay resident for as long as we hold the handles. Until
+  // they have been uploaded the handles show a placeholder
+  TextureCache texture_cache;
+  TextureHandle diffuse_map = texture_cache.acquire_async("container2.png");
+  TextureHandle specular_map = texture_cache.acquire_async("container2_specular.png");
+  std::size_t textures_ready_frame = 0;
   
   // Main loop
-  while (!glfwWindowShouldClose(window)) {
+  while (options.frame_limit == 0 || frame_count < options.frame_limit) {
     
     // Timing logic
-    const float current_frame = glfwGetTime();
+    const float current_frame = get_time();
     delta_time = current_frame - last_frame;
     last_frame = current_frame;
     
-    glfwPollEvents();
-    
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Benchmarks replay the same camera path at a fixed step regardless of how long frames take
+    const bool measuring = options.benchmark && frame_count >= BENCHMARK_WARMUP_FRAMES;
+    const std::size_t benchmark_frame = measuring ? frame_count - BENCHMARK_WARMUP_FRAMES : 0;
+    if (options.benchmark) {
+      delta_time = 1.0f / 60.0f;
+      camera_path.apply(camera, benchmark_frame);
+    }
+    const std::size_t heap_allocations_before = get_heap_allocation_count();
     
-    // Be sure to activate the shader
-    shader.use();
+#ifndef OPENGL_NO_GLFW
+    if (window != nullptr) {
+      if (glfwWindowShouldClose(window)) {
+        break;
+      }
+      glfwPollEvents();
+    }
+#endif
+    // Started once the frame is sure to run, so closing the window never leaves a query active
+    if (measuring) {
+      gpu_timer.begin(benchmark_frame, record_gpu_time);
+    }
+    // Programs rebuilt after an edit are swapped in between frames
+    shader_library.reload();
     
-    shader.set_vec3("viewPos", camera.get_position());
-    shader.set_float("material.shininess", 32.0f);
+    Shader::reset_lookup_count();
+    render_stats().reset();
+    profiler.begin_frame();
     
-    /*
-     Here we set all the uniforms for the 5/6 types of lights we have. We have to set them manually and index
-     the proper PointLight struct in the array to set each uniform variable. This can be done more code-friendly
-     by defining light types as classes and set their values in there, or by using a more efficient uniform approach
-     by using 'Uniform buffer objects', but that is something we'll discuss in the 'Advanced GLSL' tutorial.
-    */
-    // Directional light
-    shader.set_vec3("dirLight.direction", -0.2f, -1.0f, -0.3f);
-    shader.set_vec3("dirLight.ambient", 0.05f, 0.05f, 0.05f);
-    shader.set_vec3("dirLight.diffuse", 0.4f, 0.4f, 0.4f);
-    shader.set_vec3("dirLight.specular", 0.5f, 0.5f, 0.5f);
+    {
+      GpuScope scope("clear");
+      glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
     
-    // Point light 1
-    shader.set_vec3("pointLights[0].position", point_light_positions[0]);
-    shader.set_vec3("pointLights[0].ambient", 0.05f, 0.05f, 0.05f);
-    shader.set_vec3("pointLights[0].diffuse", 0.8f, 0.8f, 0.8f);
-    shader.set_vec3("pointLights[0].specular", 1.0f, 1.0f, 1.0f);
-    shader.set_float("pointLights[0].constant", 1.0f);
-    shader.set_float("pointLights[0].linear", 0.09);
-    shader.set_float("pointLights[0].quadratic", 0.032);
+    {
+      CpuScope scope("texture_upload");
+      texture_cache.update();
+      if (textures_ready_frame == 0 && !texture_cache.is_loading()) {
+        textures_ready_frame = frame_count + 1;
+      }
+    }
     
-    // Point light 2
-    shader.set_vec3("pointLights[1].position", point_light_positions[1]);
-    shader.set_vec3("pointLights[1].ambient", 0.05f, 0.05f, 0.05f);
-    shader.set_vec3("pointLights[1].diffuse", 0.8f, 0.8f, 0.8f);
-    shader.set_vec3("pointLights[1].specular", 1.0f, 1.0f, 1.0f);
-    shader.set_float("pointLights[1].constant", 1.0f);
-    shader.set_float("pointLights[1].linear", 0.09);
-    shader.set_float("pointLights[1].quadratic", 0.032);
+    // Diffuse and specular maps
+    draw_materials[MATERIAL_CONTAINER].diffuse = diffuse_map ? diffuse_map->id : 0;
+    draw_materials[MATERIAL_CONTAINER].specular = specular_map ? specular_map->id : 0;
     
-    // Point light 3
-    shader.set_vec3("pointLights[2].position", point_light_positions[2]);
-    shader.set_vec3("pointLights[2].ambient", 0.05f, 0.05f, 0.05f);
-    shader.set_vec3("pointLights[2].diffuse", 0.8f, 0.8f, 0.8f);
-    shader.set_vec3("pointLights[2].specular", 1.0f, 1.0f, 1.0f);
-    shader.set_float("pointLights[2].constant", 1.0f);
-    shader.set_float("pointLights[2].linear", 0.09);
-    shader.set_float("pointLights[2].quadratic", 0.032);
+    // Each draw uses the variant with the features of the frame and of its material
+    const std::uint32_t frame_features = scene_features | (flashlight ? SHADER_FEATURE_SPOT_LIGHT : 0);
+    const std::uint32_t container_features = frame_features | (draw_materials[MATERIAL_CONTAINER].specular != 0 ?
+                                                               SHADER_FEATURE_SPECULAR_MAP : 0);
     
-    // Point light 4
-    shader.set_vec3("pointLights[3].position", point_light_positions[3]);
-    shader.set_vec3("pointLights[3].ambient", 0.05f, 0.05f, 0.05f);
-    shader.set_vec3("pointLights[3].diffuse", 0.8f, 0.8f, 0.8f);
-    shader.set_vec3("pointLights[3].specular", 1.0f, 1.0f, 1.0f);
-    shader.set_float("pointLights[3].constant", 1.0f);
-    shader.set_float("pointLights[3].linear", 0.09);
-    shader.set_float("pointLights[3].quadratic", 0.032);
+    const float aspect_ratio = static_cast<float>(WINDOW_WIDTH) / static_cast<float>(WINDOW_HEIGHT);
+    {
+      CpuScope scope("upload");
+      frame_ring.begin_frame();
+      FrameVector<std::uint32_t> visible_cubes = make_frame_vector<std::uint32_t>(frame_arena, cube_models.size());
+      FrameVector<std::uint32_t> visible_lights = make_frame_vector<std::uint32_t>(frame_arena, light_models.size());
+      FrameVector<InstanceData> queued_instances = make_frame_vector<InstanceData>(frame_arena, max_instances);
+      FrameVector<InstanceData> sorted_instances = make_frame_vector<InstanceData>(frame_arena, max_instances);
     
-    // Spotlight
-    shader.set_vec3("spotLight.position", camera.get_position());
-    shader.set_vec3("spotLight.direction", camera.get_front());
-    shader.set_vec3("spotLight.ambient", 0.0f, 0.0f, 0.0f);
-    shader.set_vec3("spotLight.diffuse", 1.0f, 1.0f, 1.0f);
-    shader.set_vec3("spotLight.specular", 1.0f, 1.0f, 1.0f);
-    shader.set_float("spotLight.constant", 1.0f);
-    shader.set_float("spotLight.linear", 0.09);
-    shader.set_float("spotLight.quadratic", 0.032);
-    shader.set_float("spotLight.cutOff", glm::cos(glm::radians(12.5f)));
-    shader.set_float("spotLight.outerCutOff", glm::cos(glm::radians(15.0f)));
+      // Transformations
+      CameraBlock camera_block = {};
+      camera_block.projection = camera.get_projection_matrix(aspect_ratio);
+      camera_block.view = camera.get_view_matrix();
+      camera_block.view_pos = camera.get_position();
+      camera_ubo.update(camera_block);
+      camera_ubo.stream(frame_ring);
+      
+      {
+        CpuScope assign_scope("light_assign");
+        light_clusters.assign(point_lights.data(), point_lights.size(), camera_block.view,
+                              glm::radians(camera.get_zoom()), aspect_ratio, NEAR_PLANE, FAR_PLANE);
+        
+        // Past the driver's limit the last clusters read garbage, it is the best that can be done
+        const std::vector<std::uint32_t> &indices = light_clusters.get_indices();
+        if (indices.size() > max_cluster_indices && cluster_indices <= max_cluster_indices) {
+          std::cerr << "Cluster light lists need " << indices.size() << " entries, the driver allows "
+                    << max_cluster_indices << "\n";
+        }
+        cluster_indices = indices.size();
+        cluster_range_buffer.upload(light_clusters.get_ranges().data(), CLUSTER_COUNT * sizeof(glm::uvec2));
+        cluster_index_buffer.upload(indices.data(),
+                                    std::min(cluster_indices, max_cluster_indices) * sizeof(std::uint32_t));
+      }
+      
+      // Spotlight
+      lights.spot_light.position = camera.get_position();
+      lights.spot_light.direction = camera.get_front();
+      lights.cluster_count = light_clusters.get_cluster_count();
+      lights.cluster_depth = light_clusters.get_cluster_depth();
+      light_ubo.update(lights);
+      light_ubo.stream(frame_ring);
+      
+      if (animated_count > 0) {
+        CpuScope animate_scope("animate");
+        animation_time += delta_time;
+        for (std::size_t i = 0; i < animated_count; i++) {
+          cube_models[i].model = glm::rotate(animated_placements[i], animation_time * glm::radians(30.0f + i * 5.0f),
+                                             glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+        
+        // Normals are decoded in the mesh's own space, so their matrices leave the dequantize step out
+        if (options.inverse_normals) {
+          copy_placement_matrices(cube_models.data(), animated_count);
+        }
+        else {
+          compute_normal_matrices(cube_models.data(), animated_count);
+        }
+        for (std::size_t i = 0; i < animated_count; i++) {
+          cube_models[i].model = cube_models[i].model * mesh_fits[cube_meshes[i]];
+          scene.set_transform(static_cast<std::uint32_t>(i), cube_models[i].model);
+        }
+        scene.update();
+      }
+      
+      {
+        CpuScope cull_scope("cull");
+        const Frustum frustum = camera.get_frustum(aspect_ratio);
+        const Frustum *cull_frustum = options.cull ? &frustum : nullptr;
+        gather_visible(cull_frustum, scene, cube_models.size(), visible_cubes);
+        gather_visible(cull_frustum, light_bounds, light_models.size(), visible_lights);
+      }
+      
+      // The cursor is captured for looking around, so picks go through the middle of the screen
+      if (pick_requested) {
+        CpuScope pick_scope("pick");
+        pick_requested = false;
+        glm::vec3 origin;
+        glm::vec3 direction;
+        camera.get_pick_ray(WINDOW_WIDTH * 0.5f, WINDOW_HEIGHT * 0.5f, WINDOW_WIDTH, WINDOW_HEIGHT, origin,
+                            direction);
+        RayHit hit;
+        if (scene.pick(origin, direction, hit)) {
+          std::cout << "Picked container " << hit.object << " at distance " << hit.distance << "\n";
+        }
+        else {
+          std::cout << "Picked nothing\n";
+        }
+      }
     
-    // Transformations
-    glm::mat4 projection = glm::mat4(1.0f);
-    projection = glm::perspective(glm::radians(camera.get_zoom()), static_cast<float>(WINDOW_WIDTH) /
-                                  static_cast<float>(WINDOW_HEIGHT), 0.1f, 100.0f);
+      // Per-object cost is a queued key and a copy into the instance buffer, not a uniform upload and a draw
+      // call. Sorting puts instances of the same program, textures and mesh next to each other, front to back
+      {
+        CpuScope queue_scope("queue");
+        render_queue.clear();
+        const glm::vec3 eye = camera.get_position();
+        const glm::vec3 front = camera.get_front();
+        queue_instances(cube_models, visible_cubes, cube_meshes, RENDER_PASS_OPAQUE,
+                        shader_library.find(deferred_shading ? gbuffer_program : lit_program, container_features),
+                        MATERIAL_CONTAINER, eye, front, queued_instances, render_queue);
+        queue_instances(light_models, visible_lights, light_meshes, RENDER_PASS_UNLIT,
+                        shader_library.find(lamp_program, frame_features), MATERIAL_NONE, eye, front,
+                        queued_instances, render_queue);
+        render_queue.sort();
+        
+        for (const RenderItem &item : render_queue.get_items()) {
+          sorted_instances.push_back(queued_instances[item.payload]);
+        }
+        draw_commands.clear();
+        for (const RenderBatch &batch : render_queue.get_batches()) {
+          draw_commands.add(mesh_pool.get_mesh(get_key_mesh(batch.key)), batch.first, batch.count);
+        }
+      }
+      
+      const std::size_t instance_bytes = sorted_instances.size() * sizeof(InstanceData);
+      const RingAllocation instance_allocation = frame_ring.allocate(instance_bytes, alignof(InstanceData));
+      if (instance_allocation.data != nullptr) {
+        std::memcpy(instance_allocation.data, sorted_instances.data(), instance_bytes);
+        draw_commands.set_instances(frame_ring.get_id(), instance_allocation.offset);
+      }
+      else {
+        overflow_instances.upload(sorted_instances.data(), sorted_instances.size());
+        draw_commands.set_instances(overflow_instances.get_id(), 0);
+      }
+      draw_commands.upload(frame_ring);
+      frame_ring.finish_writes();
+    }
     
-    // Note: currently we set the projection matrix each frame, but since the projection matrix rarely changes it's often best practice to set it outside the main loop only once.
-    shader.set_mat4("projection", projection);
+    point_light_buffer.bind(POINT_LIGHT_TEXTURE_UNIT);
+    cluster_range_buffer.bind(CLUSTER_RANGE_TEXTURE_UNIT);
+    cluster_index_buffer.bind(CLUSTER_INDEX_TEXTURE_UNIT);
     
-    // Camera/view transformation
-    glm::mat4 view = camera.get_view_matrix();
-    shader.set_mat4("view", view);
+    if (!deferred_shading) {
+      GpuScope scope("lit_cubes");
+      submit_pass(render_queue, RENDER_PASS_OPAQUE, shader_library, draw_materials, draw_commands, mesh_pool);
+    }
+    else {
+      GLint viewport[4];
+      glGetIntegerv(GL_VIEWPORT, viewport);
+      if (gbuffer == nullptr) {
+        gbuffer.reset(new GBuffer(viewport[2], viewport[3]));
+        std::cout << "G-buffer: " << gbuffer->get_bytes() / 1024 << " KB\n";
+      }
+      
+      {
+        GpuScope scope("gbuffer");
+        gbuffer->resize(viewport[2], viewport[3]);
+        gbuffer->bind();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        submit_pass(render_queue, RENDER_PASS_OPAQUE, shader_library, draw_materials, draw_commands, mesh_pool);
+      }
+      
+      {
+        GpuScope scope("deferred_lighting");
+        if (offscreen != nullptr) {
+          offscreen->bind();
+        }
+        else {
+          gl_state().bind_framebuffer(0);
+          gl_state().viewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        }
+        
+        // Every covered pixel is lit exactly once, and carries the G-buffer's depth over for the passes after
+        const std::uint32_t deferred_variant = shader_library.find(deferred_program, frame_features);
+        shader_library.get(deferred_variant).use();
+        inverse_view_projection[deferred_variant].set(glm::inverse(camera.get_projection_matrix(aspect_ratio) *
+                                                                   camera.get_view_matrix()));
+        gbuffer->bind_textures();
+        gl_state().depth_func(GL_ALWAYS);
+        gl_state().bind_vertex_array(screen_vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        ++render_stats().draw_calls;
+        gl_state().depth_func(GL_LESS);
+      }
+    }
     
-    glm::mat4 model = glm::mat4(1.0f);
-    shader.set_mat4("model", model);
+    {
+      GpuScope scope("light_cubes");
+      
+      // Also draw the light object
+      submit_pass(render_queue, RENDER_PASS_UNLIT, shader_library, draw_materials, draw_commands, mesh_pool);
+    }
+
+    frame_ring.end_frame();
+    frame_arena.reset();
+    uniform_lookups = Shader::get_lookup_count();
+    drawn_objects = render_stats().drawn_objects;
+    culled_objects = render_stats().culled_objects;
+    state_calls = render_stats().state_calls;
+    skipped_state_calls = render_stats().skipped_state_calls;
     
-    // Bind diffuse map
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, load_texture("container2.png"));
+    if (measuring) {
+      gpu_timer.end(benchmark_frame);
+      FrameRecord &record = recorder.add_frame();
+      record.cpu_ms = (get_time() - current_frame) * 1000.0;
+      record.draw_calls = render_stats().draw_calls;
+      record.uniform_calls = render_stats().uniform_calls;
+      record.drawn_objects = render_stats().drawn_objects;
+      record.culled_objects = render_stats().culled_objects;
+      record.state_calls = render_stats().state_calls;
+      record.skipped_state_calls = render_stats().skipped_state_calls;
+      record.heap_allocations = get_heap_allocation_count() - heap_allocations_before;
+      gpu_timer.poll(record_gpu_time);
+    }
+    profiler.end_frame();
     
-    // Bind specular map
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, load_texture("container2_specular.png"));
+    // The first frames load textures and grow every buffer to its working size, after that nothing should allocate
+    heap_allocations = get_heap_allocation_count() - heap_allocations_before;
+    if (heap_allocations > 0 && frame_count >= BENCHMARK_WARMUP_FRAMES && textures_ready_frame != 0) {
+      if (allocating_frames == 0) {
+        std::cerr << "Frame " << frame_count << " made " << heap_allocations << " heap allocations\n";
+      }
+      ++allocating_frames;
+    }
+    frame_count++;
     
-    glBindVertexArray(VAO); // seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-    for (unsigned int i = 0; i < 10; i++) {
-      // Calculate the model matrix for each object and pass it to shader before drawing
-      glm::mat4 model = glm::mat4(1.0f);
-      model = glm::translate(model, cube_positions[i]);
-      const float angle = 20.0f * i;
-      model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-      shader.set_mat4("model", model);
+    // Offscreen frames are submitted the same way a swap would, so they cannot pile up in the driver
+    if (offscreen != nullptr) {
+      glFlush();
+    }
+#ifndef OPENGL_NO_GLFW
+    else {
+      glfwSwapBuffers(window);
+    }
+#endif
+  }
+  
+  // Make sure the GPU has actually finished before taking the time
+  glFinish();
+  
+  if (options.benchmark) {
+    gpu_timer.poll(record_gpu_time, true);
+    recorder.print_summary(std::cout);
+    if (!options.trace_path.empty()) {
+      recorder.write_trace(options.trace_path);
+    }
+  }
+  
+  // Clean up
+  if (frame_count > 0) {
+    const double elapsed = get_time() - start_time;
+    std::cout << "Average frame time: " << elapsed * 1000.0 / frame_count << " ms (" << frame_count / elapsed
+              << " fps) over " << frame_count << " frames with " << cube_models.size() << " cubes\n";
+  }
+  if (offscreen != nullptr && !options.output_path.empty()) {
+    offscreen->save_ppm(options.output_path);
+  }
+  profiler.flush();
+  profiler.print_summary(std::cout);
+  if (!options.profile_path.empty()) {
+    profiler.write_trace(options.profile_path);
+  }
+  std::cout << "Uniform lookups by name per frame: " << uniform_lookups << "\n";
+  std::cout << "Objects in the last frame: " << drawn_objects << " drawn, " << culled_objects << " culled\n";
+  std::cout << "State calls in the last frame: " << state_calls << " issued, " << skipped_state_calls
+            << " skipped as redundant\n";
+  if (HEAP_ALLOCATIONS_COUNTED) {
+    std::cout << "Heap allocations in the last frame: " << heap_allocations << ", " << allocating_frames
+              << " steady state frames allocated\n";
+  }
+  std::cout << "Frame arena: " << frame_arena.get_peak() << " of " << frame_arena.get_capacity()
+            << " bytes used at peak, " << frame_arena.get_overflow_count() << " allocations overflowed\n";
+  std::cout << "Frame ring: " << frame_ring.get_used() << " bytes streamed in the last frame, "
+            << frame_ring.get_waits() << " frames waited on the GPU\n";
+  std::uint32_t busiest_cluster = 0;
+  for (const glm::uvec2 &range : light_clusters.get_ranges()) {
+    busiest_cluster = std::max(busiest_cluster, range.y);
+  }
+  std::cout << "Point lights: " << point_lights.size() << " in " << CLUSTER_COUNT << " clusters, "
+            << cluster_indices << " cluster entries in the last frame, at most " << busiest_cluster
+            << " per cluster, assigned on " << light_clusters.get_thread_count() << " threads\n";
+  std::cout << "Textures ready at frame " << textures_ready_frame << "\n";
+  texture_cache.print_stats(std::cout);
+  diffuse_map.reset();
+  specular_map.reset();
+  texture_cache.trim();
+  gl_state().forget_vertex_array(screen_vao);
+  glDeleteVertexArrays(1, &screen_vao);
+  
+  return 0;
+}
 
-      glDrawArrays(GL_TRIANGLES, 0, 36);
+// Main function
+int main(int argc, const char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  
+#ifdef OPENGL_HAS_EGL
+  // Headless runs get their own context with no window system at all
+  if (options.headless) {
+    HeadlessContext context;
+    if (!context.is_valid() || !load_gl_functions(HeadlessContext::get_proc_address)) {
+      std::cerr << "Failed to create a headless OpenGL context\n";
+      return -1;
     }
+    return run(options, nullptr);
+  }
+#endif
+  
+#ifdef OPENGL_NO_GLFW
+  std::cerr << "Built without GLFW, only --headless rendering is available\n";
+  return -1;
+#else
+  // Callback City
+  const auto error_callback = [](int error, const char *description) {
+    std::cerr << "Error: " << description << "\n";
+  };
+  
+  const auto frame_buffer_size_callback = [](GLFWwindow *window, const int width, const int height) {
+    gl_state().viewport(0, 0, width, height);
+  };
+  
+  // Initialize GLFW
+  if (!glfwInit()) {
+    std::cout << "GLFW failed to initialize! Quitting program...\n";
+    return -1;
+  }
+  
+  // Setup windows. Without EGL a headless run still needs a context, so it gets a hidden window
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+  glfwWindowHint(GLFW_VISIBLE, options.headless ? GLFW_FALSE : GLFW_TRUE);
+  
+  GLFWwindow *window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "My Window", nullptr, nullptr);
+  
+  if (window == nullptr) {
+    std::cerr << "Failed to create GLFW window\n";
+    kill_glfw();
+    return -1;
+  }
+  
+  glfwMakeContextCurrent(window);
+  
+  // Benchmarks measure the renderer, not the display's refresh rate
+  if (options.benchmark) {
+    glfwSwapInterval(0);
+  }
+  
+  const auto get_proc_address = [](const char *name) {
+    return reinterpret_cast<void*>(glfwGetProcAddress(name));
+  };
+  if (!load_gl_functions(get_proc_address)) {
+    std::cerr << "Failed to load OpenGL functions\n";
+    glfwDestroyWindow(window);
+    kill_glfw();
+    return -1;
+  }
+  
+  // Set Callbacks
+  glfwSetErrorCallback(error_callback);
+  
+  if (!options.headless) {
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
     
-    // Also draw the light object
-    lighting_shader.use();
-    lighting_shader.set_mat4("projection", projection);
-    lighting_shader.set_mat4("view", view);
+    int window_width, window_height;
+    glfwGetFramebufferSize(window, &window_width, &window_height);
+    gl_state().viewport(0, 0, window_width, window_height);
+    glfwSetFramebufferSizeCallback(window, frame_buffer_size_callback);
     
-    glBindVertexArray(light_vao);
-    for (unsigned int i = 0; i < 4; i++) {
-      model = glm::mat4(1.0f);
-      model = glm::translate(model, point_light_positions[i]);
-      model = glm::scale(model, glm::vec3(0.2f)); // a smaller cube
-      lighting_shader.set_mat4("model", model);
-      glDrawArrays(GL_TRIANGLES, 0, 36);
-    }
-
-    glfwSwapBuffers(window);
+    // Tell GLFW to capture our mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
   }
   
-  // Clean up
-  glDeleteVertexArrays(1, &VAO);
-  glDeleteVertexArrays(1, &light_vao);
-  glDeleteBuffers(1, &VBO);
-  shader.~Shader();
+  const int result = run(options, window);
   
   // Kill program
   glfwDestroyWindow(window);
   kill_glfw();
-  return 0;
+  return result;
+#endif
 }
 
+#ifndef OPENGL_NO_GLFW
 // Implementation of dead callbacks
 void key_callback(GLFWwindow *window, const int key, const int scancode,
                   const int action, const int mods) {
@@ -412,6 +1237,14 @@ void key_callback(GLFWwindow *window, const int key, const int scancode,
   else if (key == GLFW_KEY_D && action == GLFW_PRESS) {
     camera.process_keyboard(RIGHT, delta_time);
   }
+  else if (key == GLFW_KEY_G && action == GLFW_PRESS) {
+    deferred_shading = !deferred_shading;
+    std::cout << (deferred_shading ? "Deferred" : "Forward") << " shading\n";
+  }
+  else if (key == GLFW_KEY_F && action == GLFW_PRESS) {
+    flashlight = !flashlight;
+    std::cout << "Flashlight " << (flashlight ? "on" : "off") << "\n";
+  }
 
 }
 
@@ -435,3 +1268,10 @@ void mouse_callback(GLFWwindow *window, const double x_position, const double y_
 void scroll_callback(GLFWwindow *window, const double x_offset, const double y_offset) {
   camera.process_mouse_scroll(y_offset);
 }
+
+void mouse_button_callback(GLFWwindow *window, const int button, const int action, const int mods) {
+  if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
+    pick_requested = true;
+  }
+}
+#endif
@@ -0,0 +1,136 @@
+//
+//  mapped_file.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef mapped_file_h
+#define mapped_file_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Size and modification time of a file, enough to tell whether something derived from it is stale. The time is
+// in nanoseconds since the epoch, so a file saved again within the same second still reads as changed
+struct FileStamp {
+  std::uint64_t size = 0;
+  std::int64_t modified = 0;
+
+  bool operator==(const FileStamp &other) const {
+    return size == other.size && modified == other.modified;
+  }
+};
+
+inline bool get_file_stamp(const std::string &path, FileStamp &stamp) {
+  struct stat info;
+  if (stat(path.c_str(), &info) != 0) {
+    return false;
+  }
+  stamp.size = static_cast<std::uint64_t>(info.st_size);
+#if defined(__APPLE__)
+  stamp.modified = static_cast<std::int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+  stamp.modified = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+  return true;
+}
+
+// Read-only view of a whole file mapped into memory. Pages are only read from disk once touched, so opening is
+// close to free however large the file is
+class MappedFile {
+
+public:
+  // Ctor
+  MappedFile() = default;
+
+  explicit MappedFile(const std::string &path) {
+    open(path);
+  }
+
+  // Dtor
+  ~MappedFile() {
+    close();
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile &&other) noexcept
+  : data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  MappedFile& operator=(MappedFile &&other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+
+  bool open(const std::string &path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+      ::close(fd);
+      return false;
+    }
+
+    // The mapping keeps its own reference to the file
+    void *data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = static_cast<std::size_t>(info.st_size);
+    return true;
+  }
+
+  void close() {
+    if (data_ != nullptr) {
+      munmap(const_cast<unsigned char*>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  // Asks the kernel to read the whole file ahead, for when every byte is about to be used
+  void prefetch() const {
+    if (data_ != nullptr) {
+      madvise(const_cast<unsigned char*>(data_), size_, MADV_WILLNEED);
+    }
+  }
+
+  bool is_open() const {
+    return data_ != nullptr;
+  }
+
+  const unsigned char* get_data() const {
+    return data_;
+  }
+
+  std::size_t get_size() const {
+    return size_;
+  }
+
+private:
+  const unsigned char *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+#endif /* mapped_file_h */
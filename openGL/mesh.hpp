@@ -0,0 +1,99 @@
+//
+//  mesh.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef mesh_h
+#define mesh_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "vertex_format.hpp"
+
+// CPU side geometry, indexed triangles
+struct MeshData {
+  std::vector<Vertex> vertices;
+  std::vector<std::uint32_t> indices;
+};
+
+// Geometry already in the layout MeshPool uploads, pointing into a PackedMesh or straight into a mapped mesh cache
+struct PackedMeshView {
+  VertexBounds bounds;
+  const PackedVertex *vertices = nullptr;
+  std::size_t vertex_count = 0;
+  const void *indices = nullptr;
+  std::size_t index_count = 0;
+  GLenum index_type = GL_UNSIGNED_SHORT;
+};
+
+inline std::size_t get_index_size(const GLenum index_type) {
+  return index_type == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+// Encoded geometry owning its memory. Indices are 16 bits whenever every vertex is addressable with them
+struct PackedMesh {
+  VertexBounds bounds;
+  std::vector<PackedVertex> vertices;
+  std::vector<unsigned char> indices;
+  std::size_t index_count = 0;
+  GLenum index_type = GL_UNSIGNED_SHORT;
+
+  PackedMeshView get_view() const {
+    PackedMeshView view;
+    view.bounds = bounds;
+    view.vertices = vertices.data();
+    view.vertex_count = vertices.size();
+    view.indices = indices.data();
+    view.index_count = index_count;
+    view.index_type = index_type;
+    return view;
+  }
+};
+
+inline PackedMesh pack_mesh(const MeshData &data) {
+  PackedMesh packed;
+  packed.bounds = compute_vertex_bounds(data.vertices.data(), data.vertices.size());
+  packed.vertices.resize(data.vertices.size());
+  encode_vertices(data.vertices.data(), data.vertices.size(), packed.bounds, packed.vertices.data());
+
+  packed.index_count = data.indices.size();
+  packed.index_type = data.vertices.size() <= 0x10000 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+  packed.indices.resize(packed.index_count * get_index_size(packed.index_type));
+  if (packed.index_type == GL_UNSIGNED_SHORT) {
+    std::uint16_t *out = reinterpret_cast<std::uint16_t*>(packed.indices.data());
+    std::copy(data.indices.begin(), data.indices.end(), out);
+  }
+  else {
+    std::memcpy(packed.indices.data(), data.indices.data(), packed.indices.size());
+  }
+  return packed;
+}
+
+// Points locations 0 to 2 of the bound vertex array at PackedVertex data in the bound array buffer
+inline void set_vertex_attributes() {
+  // Position attribute
+  glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex),
+                        (void*)offsetof(PackedVertex, position));
+  glEnableVertexAttribArray(0);
+
+  // Normal attribute
+  glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+  glEnableVertexAttribArray(1);
+
+  // Texture attribute
+  glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+                        (void*)offsetof(PackedVertex, tex_coords));
+  glEnableVertexAttribArray(2);
+}
+
+#endif /* mesh_h */
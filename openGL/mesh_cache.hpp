@@ -0,0 +1,130 @@
+//
+//  mesh_cache.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef mesh_cache_h
+#define mesh_cache_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Local Includes
+#include "mapped_file.hpp"
+#include "mesh.hpp"
+
+// "MSHC". Bump the version whenever the layout below or anything it stores changes meaning, like the vertex
+// encoding or the optimizer
+const std::uint32_t MESH_CACHE_MAGIC = 0x4348534D;
+const std::uint32_t MESH_CACHE_VERSION = 2;
+
+// Sections start on this boundary so the mapped vertices can be read in place
+const std::size_t MESH_CACHE_ALIGNMENT = 64;
+
+// A mesh cache is this header followed by PackedVertex data and index data at the given offsets, exactly as
+// MeshPool uploads them. The source file's stamp tells a stale cache apart
+struct MeshCacheHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t vertex_size;
+  std::uint32_t index_type;
+  std::uint64_t vertex_count;
+  std::uint64_t index_count;
+  std::uint64_t vertex_offset;
+  std::uint64_t index_offset;
+  std::uint64_t source_size;
+  std::int64_t source_modified;
+  float bounds_min[3];
+  float bounds_extent[3];
+};
+
+static_assert(sizeof(MeshCacheHeader) == 88, "MeshCacheHeader must be tightly packed");
+
+inline std::size_t align_mesh_cache_offset(const std::size_t offset) {
+  return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+}
+
+// Maps a cache file and points view at its contents. Fails on anything that does not match this build or
+// source, in which case the caller should rebuild the cache
+inline bool open_mesh_cache(const std::string &path, const FileStamp &source, MappedFile &file,
+                            PackedMeshView &view) {
+  if (!file.open(path) || file.get_size() < sizeof(MeshCacheHeader)) {
+    file.close();
+    return false;
+  }
+
+  MeshCacheHeader header;
+  std::memcpy(&header, file.get_data(), sizeof(header));
+  const std::uint64_t index_size = header.index_type == GL_UNSIGNED_SHORT ? 2 :
+                                   header.index_type == GL_UNSIGNED_INT ? 4 : 0;
+  if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION ||
+      header.vertex_size != sizeof(PackedVertex) || index_size == 0 ||
+      header.source_size != source.size || header.source_modified != source.modified ||
+      header.vertex_offset % MESH_CACHE_ALIGNMENT != 0 || header.index_offset % MESH_CACHE_ALIGNMENT != 0 ||
+      header.vertex_offset + header.vertex_count * sizeof(PackedVertex) > file.get_size() ||
+      header.index_offset + header.index_count * index_size > file.get_size()) {
+    file.close();
+    return false;
+  }
+
+  view.bounds.min = glm::vec3(header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]);
+  view.bounds.extent = glm::vec3(header.bounds_extent[0], header.bounds_extent[1], header.bounds_extent[2]);
+  view.vertices = reinterpret_cast<const PackedVertex*>(file.get_data() + header.vertex_offset);
+  view.vertex_count = static_cast<std::size_t>(header.vertex_count);
+  view.indices = file.get_data() + header.index_offset;
+  view.index_count = static_cast<std::size_t>(header.index_count);
+  view.index_type = header.index_type;
+
+  // Everything is about to be handed to glBufferData, read it ahead instead of faulting in page by page
+  file.prefetch();
+  return true;
+}
+
+// Writes through a temporary file renamed into place, so a crash halfway never leaves a broken cache behind
+inline bool write_mesh_cache(const std::string &path, const FileStamp &source, const PackedMeshView &view) {
+  MeshCacheHeader header = {};
+  header.magic = MESH_CACHE_MAGIC;
+  header.version = MESH_CACHE_VERSION;
+  header.vertex_size = sizeof(PackedVertex);
+  header.index_type = view.index_type;
+  header.vertex_count = view.vertex_count;
+  header.index_count = view.index_count;
+  header.vertex_offset = align_mesh_cache_offset(sizeof(MeshCacheHeader));
+  header.index_offset = align_mesh_cache_offset(header.vertex_offset + view.vertex_count * sizeof(PackedVertex));
+  header.source_size = source.size;
+  header.source_modified = source.modified;
+  for (int i = 0; i < 3; i++) {
+    header.bounds_min[i] = view.bounds.min[i];
+    header.bounds_extent[i] = view.bounds.extent[i];
+  }
+
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    const char padding[MESH_CACHE_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, static_cast<std::streamsize>(header.vertex_offset - sizeof(header)));
+    file.write(reinterpret_cast<const char*>(view.vertices),
+               static_cast<std::streamsize>(view.vertex_count * sizeof(PackedVertex)));
+    file.write(padding, static_cast<std::streamsize>(header.index_offset - header.vertex_offset -
+                                                     view.vertex_count * sizeof(PackedVertex)));
+    file.write(static_cast<const char*>(view.indices),
+               static_cast<std::streamsize>(view.index_count * get_index_size(view.index_type)));
+    if (!file) {
+      file.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+#endif /* mesh_cache_h */
@@ -0,0 +1,303 @@
+//
+//  mesh_optimizer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef mesh_optimizer_h
+#define mesh_optimizer_h
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+// Local Includes
+#include "mesh.hpp"
+
+// Post-transform cache size assumed when measuring. Small enough to be pessimistic for current hardware
+const std::size_t VERTEX_CACHE_MEASURE_SIZE = 16;
+
+// Post-transform cache size the optimizer orders triangles for
+const int VERTEX_CACHE_OPTIMIZE_SIZE = 32;
+
+struct VertexCacheStats {
+  // Average cache miss ratio, vertices shaded per triangle. 3 without any reuse, 0.5 at best for large grids
+  double acmr = 0.0;
+
+  // Average transformed vertex ratio, vertices shaded per unique vertex. 1 is ideal
+  double atvr = 0.0;
+};
+
+// Simulates a FIFO post-transform cache over the index buffer
+inline VertexCacheStats analyze_vertex_cache(const std::vector<std::uint32_t> &indices,
+                                             const std::size_t vertex_count,
+                                             const std::size_t cache_size = VERTEX_CACHE_MEASURE_SIZE) {
+  VertexCacheStats stats;
+  if (indices.empty() || vertex_count == 0) {
+    return stats;
+  }
+
+  // Each vertex remembers when it entered the cache, it is still in there while fewer than cache_size misses
+  // have happened since
+  std::vector<std::size_t> entered(vertex_count, 0);
+  std::size_t misses = 0;
+  for (const std::uint32_t index : indices) {
+    if (entered[index] == 0 || misses - entered[index] >= cache_size) {
+      ++misses;
+      entered[index] = misses;
+    }
+  }
+
+  stats.acmr = static_cast<double>(misses) / (indices.size() / 3);
+  stats.atvr = static_cast<double>(misses) / vertex_count;
+  return stats;
+}
+
+// Builds an index buffer for a triangle list by merging bitwise identical vertices
+inline MeshData deduplicate_vertices(const Vertex *vertices, const std::size_t count) {
+  struct VertexHash {
+    std::size_t operator()(const Vertex &vertex) const {
+      // FNV-1a over the raw bits, a word at a time
+      std::uint32_t words[sizeof(Vertex) / 4];
+      std::memcpy(words, &vertex, sizeof(Vertex));
+      std::uint32_t h = 2166136261u;
+      for (const std::uint32_t word : words) {
+        h = (h ^ word) * 16777619u;
+      }
+      return h ^ (h >> 15);
+    }
+  };
+  struct VertexEqual {
+    bool operator()(const Vertex &a, const Vertex &b) const {
+      return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+    }
+  };
+
+  MeshData mesh;
+  mesh.indices.reserve(count);
+  std::unordered_map<Vertex, std::uint32_t, VertexHash, VertexEqual> remap;
+  remap.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    auto inserted = remap.emplace(vertices[i], static_cast<std::uint32_t>(mesh.vertices.size()));
+    if (inserted.second) {
+      mesh.vertices.push_back(vertices[i]);
+    }
+    mesh.indices.push_back(inserted.first->second);
+  }
+  return mesh;
+}
+
+namespace forsyth {
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+inline float compute_vertex_score(const int cache_position, const std::size_t remaining_triangles) {
+  if (remaining_triangles == 0) {
+    return -1.0f;
+  }
+
+  float score = 0.0f;
+  if (cache_position >= 0) {
+    // The three vertices of the last triangle get a fixed score so the next triangle does not simply reuse them
+    if (cache_position < 3) {
+      score = LAST_TRIANGLE_SCORE;
+    }
+    else {
+      const float scaler = 1.0f / (VERTEX_CACHE_OPTIMIZE_SIZE - 3);
+      score = std::pow(1.0f - (cache_position - 3) * scaler, CACHE_DECAY_POWER);
+    }
+  }
+
+  // Vertices with few triangles left are worth finishing off
+  score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining_triangles), -VALENCE_BOOST_POWER);
+  return score;
+}
+
+// Scores looked up for the common cases, the pow calls dominate otherwise
+const std::size_t MAX_TABLE_VALENCE = 32;
+
+inline float vertex_score(const int cache_position, const std::size_t remaining_triangles) {
+  struct Table {
+    float scores[VERTEX_CACHE_OPTIMIZE_SIZE + 1][MAX_TABLE_VALENCE];
+
+    Table() {
+      for (int position = -1; position < VERTEX_CACHE_OPTIMIZE_SIZE; position++) {
+        for (std::size_t valence = 0; valence < MAX_TABLE_VALENCE; valence++) {
+          scores[position + 1][valence] = compute_vertex_score(position, valence);
+        }
+      }
+    }
+  };
+  static const Table table;
+
+  if (remaining_triangles >= MAX_TABLE_VALENCE) {
+    return compute_vertex_score(cache_position, remaining_triangles);
+  }
+  return table.scores[cache_position + 1][remaining_triangles];
+}
+
+}
+
+// Reorders triangles so vertices are reused while still in the post-transform cache. Greedily emits the
+// triangle whose vertices score best, where vertices recently used and with few triangles left score highest
+inline void optimize_vertex_cache(std::vector<std::uint32_t> &indices, const std::size_t vertex_count) {
+  const std::size_t triangle_count = indices.size() / 3;
+  if (triangle_count == 0) {
+    return;
+  }
+
+  // Triangles using each vertex, packed into one array
+  std::vector<std::size_t> remaining(vertex_count, 0);
+  for (const std::uint32_t index : indices) {
+    ++remaining[index];
+  }
+  std::vector<std::size_t> offsets(vertex_count + 1, 0);
+  for (std::size_t v = 0; v < vertex_count; v++) {
+    offsets[v + 1] = offsets[v] + remaining[v];
+  }
+  std::vector<std::size_t> adjacency(indices.size());
+  std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+  for (std::size_t t = 0; t < triangle_count; t++) {
+    for (int k = 0; k < 3; k++) {
+      adjacency[fill[indices[t * 3 + k]]++] = t;
+    }
+  }
+
+  std::vector<int> cache_position(vertex_count, -1);
+  std::vector<float> scores(vertex_count);
+  for (std::size_t v = 0; v < vertex_count; v++) {
+    scores[v] = forsyth::vertex_score(-1, remaining[v]);
+  }
+
+  std::vector<float> triangle_scores(triangle_count);
+  std::vector<bool> emitted(triangle_count, false);
+  for (std::size_t t = 0; t < triangle_count; t++) {
+    triangle_scores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+  }
+
+  std::vector<std::uint32_t> result;
+  result.reserve(indices.size());
+  std::vector<std::uint32_t> cache;
+  std::vector<std::uint32_t> next_cache;
+
+  std::size_t best = 0;
+  for (std::size_t t = 1; t < triangle_count; t++) {
+    if (triangle_scores[t] > triangle_scores[best]) {
+      best = t;
+    }
+  }
+  std::size_t scan = 0;
+
+  for (std::size_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+    // Nothing in the cache has triangles left, fall back to the next triangle not emitted yet
+    if (best == triangle_count) {
+      while (emitted[scan]) {
+        ++scan;
+      }
+      best = scan;
+    }
+
+    emitted[best] = true;
+    const std::uint32_t *triangle = &indices[best * 3];
+    result.insert(result.end(), triangle, triangle + 3);
+
+    // Take the triangle off its vertices' lists
+    for (int k = 0; k < 3; k++) {
+      const std::uint32_t v = triangle[k];
+      std::size_t *begin = &adjacency[offsets[v]];
+      std::size_t *end = begin + remaining[v];
+      std::iter_swap(std::find(begin, end, best), end - 1);
+      --remaining[v];
+    }
+
+    // Most recently used first, the overflow past the simulated size drops out
+    next_cache.assign(triangle, triangle + 3);
+    for (const std::uint32_t v : cache) {
+      if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+        next_cache.push_back(v);
+      }
+    }
+    for (std::size_t i = 0; i < next_cache.size(); i++) {
+      const std::uint32_t v = next_cache[i];
+      cache_position[v] = i < static_cast<std::size_t>(VERTEX_CACHE_OPTIMIZE_SIZE) ? static_cast<int>(i) : -1;
+      scores[v] = forsyth::vertex_score(cache_position[v], remaining[v]);
+    }
+    if (next_cache.size() > static_cast<std::size_t>(VERTEX_CACHE_OPTIMIZE_SIZE)) {
+      next_cache.resize(VERTEX_CACHE_OPTIMIZE_SIZE);
+    }
+    cache.swap(next_cache);
+
+    // Only triangles touching the cache changed score, the best of them goes next
+    best = triangle_count;
+    float best_score = -1.0f;
+    for (const std::uint32_t v : cache) {
+      for (std::size_t i = 0; i < remaining[v]; i++) {
+        const std::size_t t = adjacency[offsets[v] + i];
+        triangle_scores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+        if (triangle_scores[t] > best_score) {
+          best_score = triangle_scores[t];
+          best = t;
+        }
+      }
+    }
+  }
+
+  indices.swap(result);
+}
+
+// Renumbers vertices in the order the index buffer first uses them, so vertex fetches walk memory forward
+inline void optimize_vertex_fetch(MeshData &mesh) {
+  const std::uint32_t UNUSED = 0xFFFFFFFFu;
+  std::vector<std::uint32_t> remap(mesh.vertices.size(), UNUSED);
+  std::vector<Vertex> vertices;
+  vertices.reserve(mesh.vertices.size());
+
+  for (std::uint32_t &index : mesh.indices) {
+    if (remap[index] == UNUSED) {
+      remap[index] = static_cast<std::uint32_t>(vertices.size());
+      vertices.push_back(mesh.vertices[index]);
+    }
+    index = remap[index];
+  }
+
+  // Vertices no triangle uses are dropped
+  mesh.vertices.swap(vertices);
+}
+
+// Orders an indexed mesh for the post-transform cache and then for vertex fetch. Prints cache statistics before
+// and after to report when given
+inline void optimize_mesh(MeshData &mesh, std::ostream *report = nullptr) {
+  const VertexCacheStats before = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+  optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+  optimize_vertex_fetch(mesh);
+  const VertexCacheStats after = analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+
+  if (report != nullptr) {
+    *report << "Mesh: " << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3 << " triangles, ACMR "
+            << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+  }
+}
+
+// Turns a non-indexed triangle list into an optimized indexed mesh
+inline MeshData build_optimized_mesh(const Vertex *vertices, const std::size_t count, std::ostream *report = nullptr) {
+  MeshData mesh = deduplicate_vertices(vertices, count);
+  if (report != nullptr) {
+    *report << "Mesh: " << count << " vertices deduplicated to " << mesh.vertices.size() << "\n";
+  }
+  optimize_mesh(mesh, report);
+  return mesh;
+}
+
+#endif /* mesh_optimizer_h */
@@ -0,0 +1,158 @@
+//
+//  mesh_pool.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef mesh_pool_h
+#define mesh_pool_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "mesh.hpp"
+
+// Where a mesh ended up in the pool, everything a draw command needs to find it
+struct PooledMesh {
+  VertexBounds bounds;
+  std::uint32_t first_index = 0;
+  std::uint32_t index_count = 0;
+  std::int32_t base_vertex = 0;
+};
+
+// Many meshes packed into one vertex and one index buffer. Indices stay relative to their own mesh and draws add
+// the mesh's base vertex, so they are 16 bits whenever no single mesh needs more, however large the pool grows.
+// Every mesh is drawn from the same vertex array, which is what lets one multi-draw call cover all of them
+class MeshPool {
+
+public:
+  // Ctor
+  MeshPool() {
+    glGenBuffers(1, &vbo_);
+    glGenBuffers(1, &ebo_);
+    glGenVertexArrays(1, &vao_);
+  }
+
+  // Dtor
+  ~MeshPool() {
+    gl_state().forget_vertex_array(vao_);
+    gl_state().forget_buffer(ebo_);
+    gl_state().forget_buffer(vbo_);
+    glDeleteVertexArrays(1, &vao_);
+    glDeleteBuffers(1, &ebo_);
+    glDeleteBuffers(1, &vbo_);
+  }
+
+  MeshPool(const MeshPool&) = delete;
+  MeshPool& operator=(const MeshPool&) = delete;
+
+  // Adds a mesh and returns its id. Nothing is copied, the geometry is read from where view points when upload()
+  // sends it to the GPU, so it has to stay there until then
+  std::uint32_t add(const PackedMeshView &view) {
+    PooledMesh mesh;
+    mesh.bounds = view.bounds;
+    mesh.first_index = static_cast<std::uint32_t>(index_count_);
+    mesh.index_count = static_cast<std::uint32_t>(view.index_count);
+    mesh.base_vertex = static_cast<std::int32_t>(vertex_count_);
+    meshes_.push_back(mesh);
+    pending_.push_back(view);
+
+    vertex_count_ += view.vertex_count;
+    index_count_ += view.index_count;
+    largest_mesh_ = std::max(largest_mesh_, view.vertex_count);
+    return static_cast<std::uint32_t>(meshes_.size() - 1);
+  }
+
+  // Sends every mesh added so far to the GPU in one go and sets up the vertex array. Each mesh is written straight
+  // from its view, only indices of another width than the pool's are converted on the way
+  void upload() {
+    index_type_ = largest_mesh_ <= 0x10000 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    const std::size_t index_size = get_index_size(index_type_);
+    vertex_bytes_ = vertex_count_ * sizeof(PackedVertex);
+    index_bytes_ = index_count_ * index_size;
+
+    gl_state().bind_vertex_array(vao_);
+    gl_state().bind_buffer(GL_ARRAY_BUFFER, vbo_);
+    glBufferData(GL_ARRAY_BUFFER, vertex_bytes_, nullptr, GL_STATIC_DRAW);
+    set_vertex_attributes();
+    gl_state().bind_buffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_bytes_, nullptr, GL_STATIC_DRAW);
+
+    std::vector<unsigned char> converted;
+    for (std::size_t i = 0; i < pending_.size(); i++) {
+      const PackedMeshView &view = pending_[i];
+      const PooledMesh &mesh = meshes_[meshes_.size() - pending_.size() + i];
+      glBufferSubData(GL_ARRAY_BUFFER, mesh.base_vertex * sizeof(PackedVertex),
+                      view.vertex_count * sizeof(PackedVertex), view.vertices);
+      if (view.index_type == index_type_) {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.first_index * index_size, view.index_count * index_size,
+                        view.indices);
+        continue;
+      }
+
+      converted.resize(view.index_count * index_size);
+      if (view.index_type == GL_UNSIGNED_SHORT) {
+        const std::uint16_t *indices = static_cast<const std::uint16_t*>(view.indices);
+        std::copy(indices, indices + view.index_count, reinterpret_cast<std::uint32_t*>(converted.data()));
+      }
+      else {
+        const std::uint32_t *indices = static_cast<const std::uint32_t*>(view.indices);
+        std::transform(indices, indices + view.index_count, reinterpret_cast<std::uint16_t*>(converted.data()),
+                       [](const std::uint32_t index) { return static_cast<std::uint16_t>(index); });
+      }
+      glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.first_index * index_size, view.index_count * index_size,
+                      converted.data());
+    }
+    pending_.clear();
+  }
+
+  const PooledMesh& get_mesh(const std::uint32_t id) const {
+    return meshes_[id];
+  }
+
+  // Append to the model matrix of everything drawn with the mesh. Normal matrices are computed from the model
+  // matrix before this is applied
+  glm::mat4 get_dequantize_matrix(const std::uint32_t id) const {
+    return ::get_dequantize_matrix(meshes_[id].bounds);
+  }
+
+  std::size_t size() const {
+    return meshes_.size();
+  }
+
+  // The one vertex array every mesh in the pool is drawn from, with its index buffer bound
+  unsigned int get_vertex_array() const {
+    return vao_;
+  }
+
+  GLenum get_index_type() const {
+    return index_type_;
+  }
+
+  // GPU memory taken by the vertex and index buffers, once uploaded
+  std::size_t get_bytes() const {
+    return vertex_bytes_ + index_bytes_;
+  }
+
+private:
+  unsigned int vbo_ = 0;
+  unsigned int ebo_ = 0;
+  unsigned int vao_ = 0;
+  GLenum index_type_ = GL_UNSIGNED_SHORT;
+  std::vector<PooledMesh> meshes_;
+  std::vector<PackedMeshView> pending_;
+  std::size_t vertex_count_ = 0;
+  std::size_t index_count_ = 0;
+  std::size_t largest_mesh_ = 0;
+  std::size_t vertex_bytes_ = 0;
+  std::size_t index_bytes_ = 0;
+};
+
+#endif /* mesh_pool_h */
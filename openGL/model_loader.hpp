@@ -0,0 +1,119 @@
+//
+//  model_loader.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef model_loader_h
+#define model_loader_h
+
+// System Includes
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Local Includes
+#include "gltf_loader.hpp"
+#include "mapped_file.hpp"
+#include "mesh.hpp"
+#include "mesh_cache.hpp"
+#include "mesh_optimizer.hpp"
+#include "obj_loader.hpp"
+
+// Geometry ready for MeshPool, either mapped straight out of a mesh cache or parsed from the source file
+struct LoadedModel {
+  MappedFile cache;
+  PackedMesh packed;
+  PackedMeshView view;
+  bool from_cache = false;
+};
+
+// The cache of model.obj lives next to it in model.obj.meshcache
+inline std::string get_mesh_cache_path(const std::string &path) {
+  return path + ".meshcache";
+}
+
+// Loads an OBJ, glTF or GLB file. A valid mesh cache is mapped and used as is. Otherwise the source is parsed,
+// optimized and packed, and the cache is written for the next run. Timings go to report when given
+inline bool load_model(const std::string &path, LoadedModel &model, std::ostream *report = nullptr) {
+  using clock = std::chrono::steady_clock;
+  const auto milliseconds_since = [](const clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+  const auto start = clock::now();
+
+  FileStamp source;
+  if (!get_file_stamp(path, source)) {
+    std::cerr << "Model not found at path: " << path << "\n";
+    return false;
+  }
+
+  const std::string cache_path = get_mesh_cache_path(path);
+  if (open_mesh_cache(cache_path, source, model.cache, model.view)) {
+    model.from_cache = true;
+    if (report != nullptr) {
+      *report << "Model " << path << ": " << model.view.index_count / 3 << " triangles mapped from "
+              << cache_path << " in " << milliseconds_since(start) << " ms\n";
+    }
+    return true;
+  }
+
+  std::string extension = path.substr(std::min(path.find_last_of('.'), path.size()));
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+  MeshData mesh;
+  ObjLoadTimes obj_times;
+  bool loaded = false;
+  if (extension == ".obj") {
+    loaded = load_obj(path, mesh, &obj_times);
+  }
+  else if (extension == ".gltf" || extension == ".glb") {
+    loaded = load_gltf(path, mesh);
+  }
+  else {
+    std::cerr << "Unknown model format: " << path << "\n";
+    return false;
+  }
+  if (!loaded || mesh.indices.empty()) {
+    std::cerr << "Model failed to load at path: " << path << "\n";
+    return false;
+  }
+  const double parse_ms = milliseconds_since(start);
+
+  const auto optimize_start = clock::now();
+  optimize_mesh(mesh, report);
+  const double optimize_ms = milliseconds_since(optimize_start);
+
+  const auto pack_start = clock::now();
+  model.packed = pack_mesh(mesh);
+  model.view = model.packed.get_view();
+  model.from_cache = false;
+  const double pack_ms = milliseconds_since(pack_start);
+
+  const bool cached = write_mesh_cache(cache_path, source, model.view);
+  if (!cached) {
+    std::cerr << "Could not write mesh cache: " << cache_path << "\n";
+  }
+
+  if (report != nullptr) {
+    *report << "Model " << path << ": " << model.view.index_count / 3 << " triangles, " << model.view.vertex_count
+            << " vertices parsed in " << milliseconds_since(start) << " ms (load " << parse_ms;
+    if (extension == ".obj") {
+      *report << " = parse " << obj_times.parse << " on " << obj_times.threads << " threads + assemble "
+              << obj_times.assemble << " + deduplicate " << obj_times.deduplicate;
+    }
+    *report << ", optimize " << optimize_ms << ", pack " << pack_ms << ")";
+    if (cached) {
+      *report << ", cached in " << cache_path;
+    }
+    *report << "\n";
+  }
+  return true;
+}
+
+#endif /* model_loader_h */
@@ -0,0 +1,90 @@
+//
+//  normal_matrix.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef normal_matrix_h
+#define normal_matrix_h
+
+// System Includes
+#include <cmath>
+#include <cstddef>
+
+// Local Includes
+#include "instance_buffer.hpp"
+#include "glm/glm.hpp"
+#include "glm/simd/matrix.h"
+
+// Counts how many normal matrices took the cheap rigid path versus a full inverse
+struct NormalMatrixStats {
+  std::size_t rigid = 0;
+  std::size_t general = 0;
+};
+
+// True when the upper 3x3 of the model is a rotation times a uniform scale. Returns that scale squared
+inline bool is_rigid_uniform_scale(const glm::mat4 &model, float &scale_squared) {
+  const glm::vec3 x(model[0]);
+  const glm::vec3 y(model[1]);
+  const glm::vec3 z(model[2]);
+
+  const float xx = glm::dot(x, x);
+  const float yy = glm::dot(y, y);
+  const float zz = glm::dot(z, z);
+  const float tolerance = 1e-4f * xx;
+
+  scale_squared = xx;
+  return std::abs(xx - yy) <= tolerance && std::abs(xx - zz) <= tolerance &&
+         std::abs(glm::dot(x, y)) <= tolerance && std::abs(glm::dot(x, z)) <= tolerance &&
+         std::abs(glm::dot(y, z)) <= tolerance && xx > 0.0f;
+}
+
+// transpose(inverse(mat3(model))) through a full 4x4 inverse, using GLM's SSE kernel where it is compiled in
+inline glm::mat3 general_normal_matrix(const glm::mat4 &model) {
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+  glm_vec4 in[4];
+  glm_vec4 out[4];
+  for (int column = 0; column < 4; column++) {
+    in[column] = _mm_loadu_ps(&model[column][0]);
+  }
+  glm_mat4_inverse(in, out);
+
+  glm::mat4 inverse;
+  for (int column = 0; column < 4; column++) {
+    _mm_storeu_ps(&inverse[column][0], out[column]);
+  }
+  return glm::transpose(glm::mat3(inverse));
+#else
+  return glm::transpose(glm::inverse(glm::mat3(model)));
+#endif
+}
+
+// Fills in the normal matrix of every instance from its model matrix. Rotation plus uniform scale, which
+// covers nearly everything we draw, only needs the upper 3x3 divided by the scale squared
+inline NormalMatrixStats compute_normal_matrices(InstanceData *instances, const std::size_t count) {
+  NormalMatrixStats stats;
+  for (std::size_t i = 0; i < count; i++) {
+    float scale_squared = 1.0f;
+    if (is_rigid_uniform_scale(instances[i].model, scale_squared)) {
+      instances[i].normal = glm::mat3(instances[i].model) / scale_squared;
+      ++stats.rigid;
+    }
+    else {
+      instances[i].normal = general_normal_matrix(instances[i].model);
+      ++stats.general;
+    }
+  }
+  return stats;
+}
+
+// What shader_inverse.vert takes in place of the normal matrix: the upper 3x3 of every model matrix, left for
+// the shader to invert. Like the normal matrix, it has to be taken before the dequantize step is appended
+inline void copy_placement_matrices(InstanceData *instances, const std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    instances[i].normal = glm::mat3(instances[i].model);
+  }
+}
+
+#endif /* normal_matrix_h */
@@ -0,0 +1,402 @@
+//
+//  obj_loader.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef obj_loader_h
+#define obj_loader_h
+
+// System Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local Includes
+#include "mapped_file.hpp"
+#include "mesh.hpp"
+#include "mesh_optimizer.hpp"
+#include "glm/glm.hpp"
+
+// Files smaller than this are parsed on the calling thread, spinning up workers costs more than it saves
+const std::size_t OBJ_MIN_PARALLEL_BYTES = 1 << 20;
+
+// Where the time of the last load_obj() went, in milliseconds
+struct ObjLoadTimes {
+  double parse = 0.0;
+  double assemble = 0.0;
+  double deduplicate = 0.0;
+  std::size_t threads = 0;
+};
+
+namespace obj {
+
+// Faster than strtof and independent of the locale. Good to a few ulps, which is far below what any exporter
+// writes out
+inline const char* parse_float(const char *p, const char *end, float &out) {
+  static const double POWERS[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+                                  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  const bool negative = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+')) {
+    ++p;
+  }
+
+  // Digits past the 19th no longer fit the mantissa and only shift the exponent
+  std::uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+    if (digits < 19) {
+      mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+      digits += mantissa != 0;
+    }
+    else {
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+        digits += mantissa != 0;
+        --exponent;
+      }
+    }
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    const bool negative_exponent = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    int value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+      value = std::min(value * 10 + (*p - '0'), 1000);
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+
+  double result = static_cast<double>(mantissa);
+  if (exponent < 0) {
+    result /= exponent >= -22 ? POWERS[-exponent] : std::pow(10.0, -exponent);
+  }
+  else if (exponent > 0) {
+    result *= exponent <= 22 ? POWERS[exponent] : std::pow(10.0, exponent);
+  }
+  out = static_cast<float>(negative ? -result : result);
+  return p;
+}
+
+inline const char* parse_int(const char *p, const char *end, std::int64_t &out) {
+  const bool negative = p < end && *p == '-';
+  if (p < end && (*p == '-' || *p == '+')) {
+    ++p;
+  }
+  std::int64_t value = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+    value = value * 10 + (*p - '0');
+  }
+  out = negative ? -value : value;
+  return p;
+}
+
+inline const char* skip_blanks(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  return p;
+}
+
+enum Attribute {
+  POSITION = 0,
+  TEX_COORDS = 1,
+  NORMAL = 2
+};
+
+// Indices of one face corner, with a bit per attribute the face gave. Positive OBJ indices count from the start
+// of the file and resolve right away. Negative ones count back from the current line, which only the chunk knows
+// about, so they are kept relative to the chunk until the chunks are stitched together
+struct Corner {
+  std::int64_t index[3] = {0, 0, 0};
+  std::uint8_t present = 0;
+  std::uint8_t relative = 0;
+
+  void set(const Attribute attribute, const std::int64_t obj_index, const std::size_t chunk_count) {
+    const std::uint8_t bit = static_cast<std::uint8_t>(1 << attribute);
+    if (obj_index > 0) {
+      index[attribute] = obj_index - 1;
+      present |= bit;
+    }
+    else if (obj_index < 0) {
+      index[attribute] = static_cast<std::int64_t>(chunk_count) + obj_index;
+      present |= bit;
+      relative |= bit;
+    }
+  }
+
+  bool has(const Attribute attribute) const {
+    return (present & (1 << attribute)) != 0;
+  }
+
+  // Index into the whole file given where the chunk's attributes start, -1 if the face did not give one
+  std::int64_t resolve(const Attribute attribute, const std::size_t chunk_base) const {
+    if (!has(attribute)) {
+      return -1;
+    }
+    if ((relative & (1 << attribute)) != 0) {
+      return static_cast<std::int64_t>(chunk_base) + index[attribute];
+    }
+    return index[attribute];
+  }
+};
+
+// Everything one thread parsed out of its run of lines
+struct Chunk {
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> tex_coords;
+  std::vector<glm::vec3> normals;
+  std::vector<Corner> corners;
+  std::size_t bad_lines = 0;
+};
+
+// Parses the lines in [begin, end). Only geometry is read, groups, materials and smoothing groups are skipped.
+// Polygons are split into fans of triangles
+inline void parse_chunk(const char *begin, const char *end, Chunk &chunk) {
+  std::vector<Corner> face;
+  const char *p = begin;
+  while (p < end) {
+    const char *line_end = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    p = skip_blanks(p, line_end);
+
+    if (line_end - p > 2 && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+      glm::vec3 position;
+      p = parse_float(skip_blanks(p + 2, line_end), line_end, position.x);
+      p = parse_float(skip_blanks(p, line_end), line_end, position.y);
+      p = parse_float(skip_blanks(p, line_end), line_end, position.z);
+      chunk.positions.push_back(position);
+    }
+    else if (line_end - p > 3 && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+      glm::vec2 tex_coords(0.0f);
+      p = parse_float(skip_blanks(p + 3, line_end), line_end, tex_coords.x);
+      p = parse_float(skip_blanks(p, line_end), line_end, tex_coords.y);
+      chunk.tex_coords.push_back(tex_coords);
+    }
+    else if (line_end - p > 3 && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+      glm::vec3 normal;
+      p = parse_float(skip_blanks(p + 3, line_end), line_end, normal.x);
+      p = parse_float(skip_blanks(p, line_end), line_end, normal.y);
+      p = parse_float(skip_blanks(p, line_end), line_end, normal.z);
+      chunk.normals.push_back(normal);
+    }
+    else if (line_end - p > 2 && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+      face.clear();
+      p = skip_blanks(p + 2, line_end);
+      while (p < line_end && *p != '\r' && *p != '#') {
+        std::int64_t index = 0;
+        Corner corner;
+        p = parse_int(p, line_end, index);
+        corner.set(POSITION, index, chunk.positions.size());
+        if (p < line_end && *p == '/') {
+          if (++p < line_end && *p != '/') {
+            p = parse_int(p, line_end, index);
+            corner.set(TEX_COORDS, index, chunk.tex_coords.size());
+          }
+          if (p < line_end && *p == '/') {
+            p = parse_int(p + 1, line_end, index);
+            corner.set(NORMAL, index, chunk.normals.size());
+          }
+        }
+        if (!corner.has(POSITION) || (p < line_end && *p != ' ' && *p != '\t' && *p != '\r')) {
+          break;
+        }
+        face.push_back(corner);
+        p = skip_blanks(p, line_end);
+      }
+
+      if (face.size() < 3 || (p < line_end && *p != '\r' && *p != '#')) {
+        ++chunk.bad_lines;
+      }
+      else {
+        for (std::size_t i = 1; i + 1 < face.size(); i++) {
+          chunk.corners.push_back(face[0]);
+          chunk.corners.push_back(face[i]);
+          chunk.corners.push_back(face[i + 1]);
+        }
+      }
+    }
+    p = line_end + 1;
+  }
+}
+
+// Expands the chunk's triangles into vertices, given where its attributes start in the whole file. Corners
+// without a normal get the normal of their face
+inline bool assemble_chunk(const Chunk &chunk, const std::vector<glm::vec3> &positions,
+                           const std::vector<glm::vec2> &tex_coords, const std::vector<glm::vec3> &normals,
+                           const std::size_t position_base, const std::size_t tex_coords_base,
+                           const std::size_t normal_base, Vertex *out) {
+  for (std::size_t i = 0; i < chunk.corners.size(); i += 3) {
+    const Corner *triangle = &chunk.corners[i];
+    glm::vec3 corner_positions[3];
+    for (int k = 0; k < 3; k++) {
+      const std::int64_t index = triangle[k].resolve(POSITION, position_base);
+      if (index < 0 || static_cast<std::size_t>(index) >= positions.size()) {
+        return false;
+      }
+      corner_positions[k] = positions[static_cast<std::size_t>(index)];
+    }
+
+    const glm::vec3 edge_cross = glm::cross(corner_positions[1] - corner_positions[0],
+                                            corner_positions[2] - corner_positions[0]);
+    const float length = glm::length(edge_cross);
+    const glm::vec3 face_normal = length > 0.0f ? edge_cross / length : glm::vec3(0.0f, 0.0f, 1.0f);
+
+    for (int k = 0; k < 3; k++) {
+      Vertex &vertex = out[i + k];
+      vertex.position = corner_positions[k];
+      vertex.normal = face_normal;
+      vertex.tex_coords = glm::vec2(0.0f);
+
+      const std::int64_t uv = triangle[k].resolve(TEX_COORDS, tex_coords_base);
+      if (uv >= 0 && static_cast<std::size_t>(uv) < tex_coords.size()) {
+        vertex.tex_coords = tex_coords[static_cast<std::size_t>(uv)];
+      }
+      const std::int64_t normal = triangle[k].resolve(NORMAL, normal_base);
+      if (normal >= 0 && static_cast<std::size_t>(normal) < normals.size()) {
+        vertex.normal = normals[static_cast<std::size_t>(normal)];
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void append_all(std::vector<T> &out, const std::vector<Chunk> &chunks, std::vector<T> Chunk::*member) {
+  std::size_t total = 0;
+  for (const Chunk &chunk : chunks) {
+    total += (chunk.*member).size();
+  }
+  out.reserve(total);
+  for (const Chunk &chunk : chunks) {
+    out.insert(out.end(), (chunk.*member).begin(), (chunk.*member).end());
+  }
+}
+
+}
+
+// Loads the triangles of a Wavefront OBJ file into an indexed mesh. Large files are split into runs of lines
+// parsed side by side, the runs are then expanded into vertices side by side and merged by
+// deduplicate_vertices(). Uses a thread per core unless given a thread count. Returns false if the file cannot
+// be read or a face points at a missing vertex
+inline bool load_obj(const std::string &path, MeshData &mesh, ObjLoadTimes *times = nullptr,
+                     const std::size_t threads = 0) {
+  using clock = std::chrono::steady_clock;
+  const auto milliseconds_since = [](const clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  };
+  const auto start = clock::now();
+
+  MappedFile file(path);
+  if (!file.is_open()) {
+    return false;
+  }
+  file.prefetch();
+  const char *begin = reinterpret_cast<const char*>(file.get_data());
+  const char *end = begin + file.get_size();
+
+  // Chunks end on line breaks so no line is split between two threads
+  std::size_t thread_count = threads != 0 ? threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  if (file.get_size() < OBJ_MIN_PARALLEL_BYTES) {
+    thread_count = 1;
+  }
+  std::vector<const char*> bounds(1, begin);
+  for (std::size_t i = 1; i < thread_count; i++) {
+    const char *split = std::max(begin + file.get_size() * i / thread_count, bounds.back());
+    const void *line_end = std::memchr(split, '\n', static_cast<std::size_t>(end - split));
+    bounds.push_back(line_end != nullptr ? static_cast<const char*>(line_end) + 1 : end);
+  }
+  bounds.push_back(end);
+
+  // Each thread runs over its own chunk, the first one on the calling thread
+  std::vector<obj::Chunk> chunks(thread_count);
+  const auto run_chunks = [thread_count](const std::function<void(std::size_t)> &work) {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < thread_count; i++) {
+      workers.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+  };
+  run_chunks([&](const std::size_t i) {
+    obj::parse_chunk(bounds[i], bounds[i + 1], chunks[i]);
+  });
+  const double parse_ms = milliseconds_since(start);
+
+  // Attribute lists are gathered in file order, then every chunk knows where its own attributes start
+  const auto assemble_start = clock::now();
+  std::vector<glm::vec3> positions;
+  std::vector<glm::vec2> tex_coords;
+  std::vector<glm::vec3> normals;
+  obj::append_all(positions, chunks, &obj::Chunk::positions);
+  obj::append_all(tex_coords, chunks, &obj::Chunk::tex_coords);
+  obj::append_all(normals, chunks, &obj::Chunk::normals);
+
+  std::vector<std::size_t> position_base(thread_count, 0);
+  std::vector<std::size_t> tex_coords_base(thread_count, 0);
+  std::vector<std::size_t> normal_base(thread_count, 0);
+  std::vector<std::size_t> corner_base(thread_count + 1, 0);
+  std::size_t bad_lines = 0;
+  for (std::size_t i = 0; i < thread_count; i++) {
+    if (i > 0) {
+      position_base[i] = position_base[i - 1] + chunks[i - 1].positions.size();
+      tex_coords_base[i] = tex_coords_base[i - 1] + chunks[i - 1].tex_coords.size();
+      normal_base[i] = normal_base[i - 1] + chunks[i - 1].normals.size();
+    }
+    corner_base[i + 1] = corner_base[i] + chunks[i].corners.size();
+    bad_lines += chunks[i].bad_lines;
+  }
+
+  std::vector<Vertex> soup(corner_base.back());
+  std::vector<char> assembled(thread_count, 0);
+  run_chunks([&](const std::size_t i) {
+    assembled[i] = obj::assemble_chunk(chunks[i], positions, tex_coords, normals, position_base[i],
+                                       tex_coords_base[i], normal_base[i], soup.data() + corner_base[i]);
+  });
+  chunks.clear();
+  const double assemble_ms = milliseconds_since(assemble_start);
+
+  if (std::find(assembled.begin(), assembled.end(), 0) != assembled.end()) {
+    std::cerr << "OBJ face refers to a missing vertex in: " << path << "\n";
+    return false;
+  }
+  if (bad_lines > 0) {
+    std::cerr << "Skipped " << bad_lines << " malformed faces in: " << path << "\n";
+  }
+
+  const auto deduplicate_start = clock::now();
+  mesh = deduplicate_vertices(soup.data(), soup.size());
+  if (times != nullptr) {
+    times->parse = parse_ms;
+    times->assemble = assemble_ms;
+    times->deduplicate = milliseconds_since(deduplicate_start);
+    times->threads = thread_count;
+  }
+  return true;
+}
+
+#endif /* obj_loader_h */
@@ -0,0 +1,315 @@
+//
+//  profiler.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef profiler_h
+#define profiler_h
+
+// System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Rolling statistics over the last WINDOW samples of one scope
+class ScopeStats {
+
+public:
+  static const std::size_t WINDOW = 128;
+
+  void add(const double ms) {
+    samples_[next_ % WINDOW] = ms;
+    ++next_;
+  }
+
+  std::size_t count() const {
+    return std::min(next_, WINDOW);
+  }
+
+  double mean() const {
+    double total = 0.0;
+    for (std::size_t i = 0; i < count(); i++) {
+      total += samples_[i];
+    }
+    return count() > 0 ? total / count() : 0.0;
+  }
+
+  double max() const {
+    double result = 0.0;
+    for (std::size_t i = 0; i < count(); i++) {
+      result = std::max(result, samples_[i]);
+    }
+    return result;
+  }
+
+private:
+  double samples_[WINDOW] = {};
+  std::size_t next_ = 0;
+};
+
+// Named CPU and GPU timing scopes. GPU scopes are bracketed with GL_TIMESTAMP queries that are only read back
+// FRAMES_IN_FLIGHT frames later, by which point the GPU has long finished them, so profiling never stalls the
+// pipeline. Scope names must be string literals since they are keyed by address.
+// The profiler constructed last is the one GpuScope and CpuScope report to
+class Profiler {
+
+public:
+  static const std::size_t FRAMES_IN_FLIGHT = 3;
+
+  // Ctor
+  explicit Profiler(const bool keep_trace = false)
+  : keep_trace_(keep_trace) {
+    previous_ = active();
+    active() = this;
+
+    // Pairs a GPU timestamp with the CPU clock so both timelines can be drawn on one axis
+    GLint64 gpu_now = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+    gpu_offset_us_ = cpu_now_us() - static_cast<double>(gpu_now) / 1000.0;
+  }
+
+  // Dtor
+  ~Profiler() {
+    for (Frame &frame : frames_) {
+      if (!frame.queries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+      }
+    }
+    active() = previous_;
+  }
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  static Profiler* get_active() {
+    return active();
+  }
+
+  // Reads back the results of the frame that last used this slot, then starts recording into it
+  void begin_frame() {
+    Frame &frame = frames_[frame_index_ % FRAMES_IN_FLIGHT];
+    resolve(frame);
+    frame.scopes.clear();
+    frame.queries_used = 0;
+  }
+
+  void end_frame() {
+    ++frame_index_;
+  }
+
+  // Blocks until every outstanding GPU scope has been read back, for use at shutdown
+  void flush() {
+    for (std::size_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
+      resolve(frames_[(frame_index_ + i) % FRAMES_IN_FLIGHT]);
+    }
+  }
+
+  std::size_t begin_scope(const char *name, const bool gpu) {
+    Frame &frame = frames_[frame_index_ % FRAMES_IN_FLIGHT];
+    Scope scope;
+    scope.name = name;
+    scope.cpu_begin_us = cpu_now_us();
+    if (gpu) {
+      scope.gpu_begin = acquire_query(frame);
+      scope.gpu_end = acquire_query(frame);
+      glQueryCounter(frame.queries[scope.gpu_begin], GL_TIMESTAMP);
+    }
+    frame.scopes.push_back(scope);
+    return frame.scopes.size() - 1;
+  }
+
+  void end_scope(const std::size_t index) {
+    Frame &frame = frames_[frame_index_ % FRAMES_IN_FLIGHT];
+    Scope &scope = frame.scopes[index];
+    if (scope.gpu_end != NO_QUERY) {
+      glQueryCounter(frame.queries[scope.gpu_end], GL_TIMESTAMP);
+    }
+    scope.cpu_end_us = cpu_now_us();
+
+    cpu_stats_[scope.name].add((scope.cpu_end_us - scope.cpu_begin_us) / 1000.0);
+    if (keep_trace_) {
+      trace_.push_back(TraceEvent{scope.name, false, scope.cpu_begin_us, scope.cpu_end_us - scope.cpu_begin_us});
+    }
+  }
+
+  void print_summary(std::ostream &out) const {
+    std::vector<const char*> names;
+    for (const auto &entry : cpu_stats_) {
+      names.push_back(entry.first);
+    }
+    std::sort(names.begin(), names.end(), [](const char *a, const char *b) {
+      return std::string(a) < std::string(b);
+    });
+
+    out << "Profiler (last " << ScopeStats::WINDOW << " frames, ms):\n";
+    for (const char *name : names) {
+      const ScopeStats &cpu = cpu_stats_.at(name);
+      out << "  " << std::left << std::setw(20) << name << std::right << " cpu mean " << cpu.mean()
+          << " max " << cpu.max();
+      const auto gpu = gpu_stats_.find(name);
+      if (gpu != gpu_stats_.end()) {
+        out << "   gpu mean " << gpu->second.mean() << " max " << gpu->second.max();
+      }
+      out << "\n";
+    }
+  }
+
+  // Chrome trace event format, loadable in chrome://tracing or Perfetto. CPU scopes are on thread 1 and GPU
+  // scopes on thread 2, both on the CPU clock
+  bool write_trace(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file) {
+      std::cerr << "Could not write " << path << "\n";
+      return false;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[\n";
+    file << "  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+    file << "  {\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+    for (const TraceEvent &event : trace_) {
+      file << ",\n  {\"name\":\"" << event.name << "\",\"cat\":\"" << (event.gpu ? "gpu" : "cpu")
+           << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (event.gpu ? 2 : 1) << ",\"ts\":" << event.begin_us
+           << ",\"dur\":" << event.duration_us << "}";
+    }
+    file << "\n]}\n";
+    return true;
+  }
+
+private:
+  static const std::size_t NO_QUERY = static_cast<std::size_t>(-1);
+
+  struct Scope {
+    const char *name = nullptr;
+    double cpu_begin_us = 0.0;
+    double cpu_end_us = 0.0;
+    std::size_t gpu_begin = NO_QUERY;
+    std::size_t gpu_end = NO_QUERY;
+  };
+
+  struct Frame {
+    std::vector<Scope> scopes;
+    std::vector<unsigned int> queries;
+    std::size_t queries_used = 0;
+  };
+
+  struct TraceEvent {
+    const char *name;
+    bool gpu;
+    double begin_us;
+    double duration_us;
+  };
+
+  static Profiler*& active() {
+    static Profiler *profiler = nullptr;
+    return profiler;
+  }
+
+  static double cpu_now_us() {
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  // Query objects are pooled per frame slot and only ever grow
+  static std::size_t acquire_query(Frame &frame) {
+    if (frame.queries_used == frame.queries.size()) {
+      unsigned int query = 0;
+      glGenQueries(1, &query);
+      frame.queries.push_back(query);
+    }
+    return frame.queries_used++;
+  }
+
+  void resolve(Frame &frame) {
+    for (const Scope &scope : frame.scopes) {
+      if (scope.gpu_begin == NO_QUERY) {
+        continue;
+      }
+
+      GLuint64 begin = 0;
+      GLuint64 end = 0;
+      glGetQueryObjectui64v(frame.queries[scope.gpu_begin], GL_QUERY_RESULT, &begin);
+      glGetQueryObjectui64v(frame.queries[scope.gpu_end], GL_QUERY_RESULT, &end);
+
+      const double duration_us = static_cast<double>(end - begin) / 1000.0;
+      gpu_stats_[scope.name].add(duration_us / 1000.0);
+      if (keep_trace_) {
+        trace_.push_back(TraceEvent{scope.name, true, static_cast<double>(begin) / 1000.0 + gpu_offset_us_,
+                                    duration_us});
+      }
+    }
+    frame.scopes.clear();
+  }
+
+  Frame frames_[FRAMES_IN_FLIGHT];
+  std::size_t frame_index_ = 0;
+
+  std::unordered_map<const char*, ScopeStats> cpu_stats_;
+  std::unordered_map<const char*, ScopeStats> gpu_stats_;
+
+  bool keep_trace_ = false;
+  double gpu_offset_us_ = 0.0;
+  std::vector<TraceEvent> trace_;
+  Profiler *previous_ = nullptr;
+};
+
+// Times the enclosing block on the CPU
+class CpuScope {
+
+public:
+  explicit CpuScope(const char *name)
+  : profiler_(Profiler::get_active()) {
+    if (profiler_ != nullptr) {
+      index_ = profiler_->begin_scope(name, false);
+    }
+  }
+
+  ~CpuScope() {
+    if (profiler_ != nullptr) {
+      profiler_->end_scope(index_);
+    }
+  }
+
+  CpuScope(const CpuScope&) = delete;
+  CpuScope& operator=(const CpuScope&) = delete;
+
+private:
+  Profiler *profiler_;
+  std::size_t index_ = 0;
+};
+
+// Times the GL commands issued in the enclosing block on the GPU, and the time spent issuing them on the CPU
+class GpuScope {
+
+public:
+  explicit GpuScope(const char *name)
+  : profiler_(Profiler::get_active()) {
+    if (profiler_ != nullptr) {
+      index_ = profiler_->begin_scope(name, true);
+    }
+  }
+
+  ~GpuScope() {
+    if (profiler_ != nullptr) {
+      profiler_->end_scope(index_);
+    }
+  }
+
+  GpuScope(const GpuScope&) = delete;
+  GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+  Profiler *profiler_;
+  std::size_t index_ = 0;
+};
+
+#endif /* profiler_h */
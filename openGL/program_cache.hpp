@@ -0,0 +1,175 @@
+//
+//  program_cache.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef program_cache_h
+#define program_cache_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Local Includes
+#include "mapped_file.hpp"
+
+// "PRGC". Bump the version whenever the layout below changes
+const std::uint32_t PROGRAM_CACHE_MAGIC = 0x43475250;
+const std::uint32_t PROGRAM_CACHE_VERSION = 1;
+
+// A program cache is this header followed by binary_length bytes of whatever glGetProgramBinary returned.
+// The source hash covers every string the program was built from and the driver that built it
+struct ProgramCacheHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t binary_format;
+  std::uint32_t binary_length;
+  std::uint64_t source_hash;
+};
+
+static_assert(sizeof(ProgramCacheHeader) == 24, "ProgramCacheHeader must be tightly packed");
+
+// Whether programs go through the binary cache, and how that went over the run
+struct ProgramCacheStats {
+  bool enabled = true;
+  std::size_t loaded = 0;
+  std::size_t compiled = 0;
+  std::size_t rejected = 0;
+  double seconds = 0.0;
+};
+
+inline ProgramCacheStats& program_cache() {
+  static ProgramCacheStats stats;
+  return stats;
+}
+
+// Whether the context can hand out program binaries and take them back. GL 4.1 has it, but drivers may still
+// offer no binary formats at all
+inline bool is_program_binary_supported() {
+#if !defined(__APPLE__)
+  if (glGetProgramBinary == nullptr || glProgramBinary == nullptr || glProgramParameteri == nullptr) {
+    return false;
+  }
+#endif
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+// FNV-1a over the driver's identity and every source string, each preceded by its length so that moving text
+// from one string to the next changes the hash. A driver update makes every binary miss rather than load
+inline std::uint64_t hash_program_sources(const std::vector<const std::string*> &sources) {
+  std::uint64_t hash = 14695981039346656037ull;
+  const auto mix = [&hash](const char *data, const std::size_t size) {
+    const std::uint64_t length = size;
+    const unsigned char *length_bytes = reinterpret_cast<const unsigned char*>(&length);
+    for (std::size_t i = 0; i < sizeof(length); i++) {
+      hash = (hash ^ length_bytes[i]) * 1099511628211ull;
+    }
+    for (std::size_t i = 0; i < size; i++) {
+      hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    }
+  };
+
+  const GLenum driver_strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION};
+  for (const GLenum name : driver_strings) {
+    const char *value = reinterpret_cast<const char*>(glGetString(name));
+    mix(value, value != nullptr ? std::strlen(value) : 0);
+  }
+  for (const std::string *source : sources) {
+    mix(source->data(), source->size());
+  }
+  return hash;
+}
+
+// The program built from shader.vert and shader.frag is cached next to them in shader.vert.shader.frag.program.
+// Variants built with defines get a hash of them in the name as well, so each keeps a binary of its own
+inline std::string get_program_cache_path(const std::string &vertex_path, const std::string &fragment_path,
+                                          const std::string &defines) {
+  const std::size_t slash = fragment_path.find_last_of("/\\");
+  std::string path = vertex_path + "." + (slash == std::string::npos ? fragment_path : fragment_path.substr(slash + 1));
+  if (!defines.empty()) {
+    std::uint32_t hash = 2166136261u;
+    for (const char c : defines) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    char tag[16];
+    std::snprintf(tag, sizeof(tag), ".%08x", static_cast<unsigned int>(hash));
+    path += tag;
+  }
+  return path + ".program";
+}
+
+// Hands a cached binary to the program. Fails on anything that does not match this build, sources and driver,
+// and when the driver refuses the binary anyway, in which case the program has to be built from source
+inline bool load_program_binary(const std::string &path, const std::uint64_t source_hash, const unsigned int program,
+                                bool &rejected) {
+  rejected = false;
+  MappedFile file;
+  if (!file.open(path) || file.get_size() < sizeof(ProgramCacheHeader)) {
+    return false;
+  }
+
+  ProgramCacheHeader header;
+  std::memcpy(&header, file.get_data(), sizeof(header));
+  if (header.magic != PROGRAM_CACHE_MAGIC || header.version != PROGRAM_CACHE_VERSION ||
+      header.source_hash != source_hash || header.binary_length == 0 ||
+      sizeof(header) + header.binary_length > file.get_size()) {
+    return false;
+  }
+
+  glProgramBinary(program, header.binary_format, file.get_data() + sizeof(header),
+                  static_cast<GLsizei>(header.binary_length));
+  GLint linked = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  rejected = linked != GL_TRUE;
+  return !rejected;
+}
+
+// Writes through a temporary file renamed into place, so a crash halfway never leaves a broken cache behind
+inline bool write_program_binary(const std::string &path, const std::uint64_t source_hash,
+                                 const unsigned int program) {
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return false;
+  }
+
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.data());
+  if (written <= 0) {
+    return false;
+  }
+
+  ProgramCacheHeader header = {};
+  header.magic = PROGRAM_CACHE_MAGIC;
+  header.version = PROGRAM_CACHE_VERSION;
+  header.binary_format = format;
+  header.binary_length = static_cast<std::uint32_t>(written);
+  header.source_hash = source_hash;
+
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    if (!file) {
+      file.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+  return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+#endif /* program_cache_h */
@@ -0,0 +1,179 @@
+//
+//  render_queue.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef render_queue_h
+#define render_queue_h
+
+// System Includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Passes in the order they are drawn. Only the lamps are drawn after deferred lighting resolves the G-buffer
+enum RenderPass : std::uint32_t {
+  RENDER_PASS_OPAQUE = 0,
+  RENDER_PASS_UNLIT = 1
+};
+
+// Layout of a sort key, most significant first. Draws sort by pass, then by everything that costs a state change
+// to switch, then front to back so early depth testing rejects as much as possible:
+//   63..60  pass
+//   59..52  program
+//   51..40  material, the textures a draw samples
+//   39..24  mesh
+//   23..0   view depth, as the top bits of a non-negative float, which order the same as the float
+const unsigned int SORT_KEY_PASS_SHIFT = 60;
+const unsigned int SORT_KEY_PROGRAM_SHIFT = 52;
+const unsigned int SORT_KEY_MATERIAL_SHIFT = 40;
+const unsigned int SORT_KEY_MESH_SHIFT = 24;
+const std::uint32_t SORT_KEY_PASS_MASK = 0xF;
+const std::uint32_t SORT_KEY_PROGRAM_MASK = 0xFF;
+const std::uint32_t SORT_KEY_MATERIAL_MASK = 0xFFF;
+const std::uint32_t SORT_KEY_MESH_MASK = 0xFFFF;
+
+inline std::uint64_t make_sort_key(const RenderPass pass, const std::uint32_t program, const std::uint32_t material,
+                                   const std::uint32_t mesh, const float depth) {
+  // Anything behind the camera, and NaN, sorts first along with depth 0
+  std::uint32_t depth_bits = 0;
+  if (depth > 0.0f) {
+    std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+  }
+  return static_cast<std::uint64_t>(pass & SORT_KEY_PASS_MASK) << SORT_KEY_PASS_SHIFT |
+         static_cast<std::uint64_t>(program & SORT_KEY_PROGRAM_MASK) << SORT_KEY_PROGRAM_SHIFT |
+         static_cast<std::uint64_t>(material & SORT_KEY_MATERIAL_MASK) << SORT_KEY_MATERIAL_SHIFT |
+         static_cast<std::uint64_t>(mesh & SORT_KEY_MESH_MASK) << SORT_KEY_MESH_SHIFT |
+         depth_bits >> 8;
+}
+
+inline RenderPass get_key_pass(const std::uint64_t key) {
+  return static_cast<RenderPass>(key >> SORT_KEY_PASS_SHIFT & SORT_KEY_PASS_MASK);
+}
+
+inline std::uint32_t get_key_program(const std::uint64_t key) {
+  return static_cast<std::uint32_t>(key >> SORT_KEY_PROGRAM_SHIFT & SORT_KEY_PROGRAM_MASK);
+}
+
+inline std::uint32_t get_key_material(const std::uint64_t key) {
+  return static_cast<std::uint32_t>(key >> SORT_KEY_MATERIAL_SHIFT & SORT_KEY_MATERIAL_MASK);
+}
+
+inline std::uint32_t get_key_mesh(const std::uint64_t key) {
+  return static_cast<std::uint32_t>(key >> SORT_KEY_MESH_SHIFT & SORT_KEY_MESH_MASK);
+}
+
+// One queued draw. The payload is whatever the submitter needs to find the draw's data again, usually an index
+struct RenderItem {
+  std::uint64_t key;
+  std::uint32_t payload;
+};
+
+// A run of sorted items that share everything but depth, so they can go out as one instanced draw
+struct RenderBatch {
+  std::uint64_t key;
+  std::uint32_t first;
+  std::uint32_t count;
+};
+
+// Draws are pushed in any order during the frame, then sorted once and walked batch by batch. Sorting is a least
+// significant digit radix sort over the eight bytes of the key, which is stable and linear in the draw count.
+// Bytes every key has in common, such as the pass and program bits of a frame with few programs, are skipped
+class RenderQueue {
+
+public:
+  void clear() {
+    items_.clear();
+    batches_.clear();
+  }
+
+  void reserve(const std::size_t count) {
+    items_.reserve(count);
+    scratch_.reserve(count);
+  }
+
+  void push(const std::uint64_t key, const std::uint32_t payload) {
+    items_.push_back(RenderItem{key, payload});
+  }
+
+  // Sorts by key and groups the result into batches. Items with equal keys keep the order they were pushed in
+  void sort() {
+    radix_sort();
+
+    batches_.clear();
+    const std::uint64_t state_mask = ~static_cast<std::uint64_t>(0) << SORT_KEY_MESH_SHIFT;
+    for (std::size_t i = 0; i < items_.size(); i++) {
+      if (batches_.empty() || (batches_.back().key & state_mask) != (items_[i].key & state_mask)) {
+        batches_.push_back(RenderBatch{items_[i].key & state_mask, static_cast<std::uint32_t>(i), 0});
+      }
+      ++batches_.back().count;
+    }
+  }
+
+  const std::vector<RenderItem>& get_items() const {
+    return items_;
+  }
+
+  const std::vector<RenderBatch>& get_batches() const {
+    return batches_;
+  }
+
+  std::size_t size() const {
+    return items_.size();
+  }
+
+  // Radix passes the last sort actually made, out of eight
+  std::size_t get_sort_passes() const {
+    return sort_passes_;
+  }
+
+private:
+  void radix_sort() {
+    const std::size_t count = items_.size();
+    sort_passes_ = 0;
+    if (count < 2) {
+      return;
+    }
+
+    // Every digit's histogram comes out of a single read over the keys
+    std::array<std::array<std::uint32_t, 256>, 8> histograms = {};
+    for (const RenderItem &item : items_) {
+      for (std::size_t digit = 0; digit < 8; digit++) {
+        ++histograms[digit][item.key >> (digit * 8) & 0xFF];
+      }
+    }
+
+    scratch_.resize(count);
+    for (std::size_t digit = 0; digit < 8; digit++) {
+      std::array<std::uint32_t, 256> &histogram = histograms[digit];
+      const std::uint32_t first_byte = items_[0].key >> (digit * 8) & 0xFF;
+      if (histogram[first_byte] == count) {
+        continue;
+      }
+
+      std::uint32_t offset = 0;
+      for (std::uint32_t &bucket : histogram) {
+        const std::uint32_t bucket_count = bucket;
+        bucket = offset;
+        offset += bucket_count;
+      }
+      for (const RenderItem &item : items_) {
+        scratch_[histogram[item.key >> (digit * 8) & 0xFF]++] = item;
+      }
+      items_.swap(scratch_);
+      ++sort_passes_;
+    }
+  }
+
+  std::vector<RenderItem> items_;
+  std::vector<RenderItem> scratch_;
+  std::vector<RenderBatch> batches_;
+  std::size_t sort_passes_ = 0;
+};
+
+#endif /* render_queue_h */
@@ -0,0 +1,34 @@
+//
+//  render_stats.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef render_stats_h
+#define render_stats_h
+
+// System Includes
+#include <cstddef>
+
+// API calls issued and objects culled during the current frame. Reset at the start of every frame
+struct RenderStats {
+  std::size_t draw_calls = 0;
+  std::size_t uniform_calls = 0;
+  std::size_t drawn_objects = 0;
+  std::size_t culled_objects = 0;
+  std::size_t state_calls = 0;
+  std::size_t skipped_state_calls = 0;
+
+  void reset() {
+    *this = RenderStats();
+  }
+};
+
+inline RenderStats& render_stats() {
+  static RenderStats stats;
+  return stats;
+}
+
+#endif /* render_stats_h */
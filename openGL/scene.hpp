@@ -0,0 +1,171 @@
+//
+//  scene.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef scene_h
+#define scene_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Local Includes
+#include "bvh.hpp"
+#include "frustum.hpp"
+#include "mesh.hpp"
+#include "glm/glm.hpp"
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/intersect.hpp"
+
+// CPU copy of a mesh's triangles for ray queries, with its own hierarchy so a ray only tests the triangles
+// near it. Positions are kept in the same [0, 1] space the shaders see before the model matrix
+struct PickMesh {
+  std::vector<glm::vec3> positions;
+  std::vector<std::uint32_t> indices;
+  Aabb bounds;
+  Bvh triangles;
+
+  static PickMesh from_packed(const PackedMeshView &view) {
+    PickMesh mesh;
+    mesh.positions.resize(view.vertex_count);
+    for (std::size_t i = 0; i < view.vertex_count; i++) {
+      const std::uint16_t *position = view.vertices[i].position;
+      mesh.positions[i] = glm::vec3(position[0], position[1], position[2]) / 65535.0f;
+      mesh.bounds.grow(mesh.positions[i]);
+    }
+
+    mesh.indices.resize(view.index_count);
+    for (std::size_t i = 0; i < view.index_count; i++) {
+      mesh.indices[i] = view.index_type == GL_UNSIGNED_SHORT ?
+                        static_cast<const std::uint16_t*>(view.indices)[i] :
+                        static_cast<const std::uint32_t*>(view.indices)[i];
+    }
+
+    std::vector<Aabb> triangle_bounds(view.index_count / 3);
+    for (std::size_t i = 0; i < triangle_bounds.size(); i++) {
+      for (std::size_t corner = 0; corner < 3; corner++) {
+        triangle_bounds[i].grow(mesh.positions[mesh.indices[i * 3 + corner]]);
+      }
+    }
+    mesh.triangles.build(triangle_bounds);
+    return mesh;
+  }
+
+  // Closest triangle hit in front of the origin, distance in units of the direction's length
+  bool raycast(const glm::vec3 &origin, const glm::vec3 &direction, float &distance) const {
+    std::uint32_t triangle = 0;
+    return triangles.raycast(origin, direction, [this, &origin, &direction](const std::uint32_t i, float &hit) {
+      glm::vec2 barycentric;
+      float t = 0.0f;
+      if (!glm::intersectRayTriangle(origin, direction, positions[indices[i * 3]], positions[indices[i * 3 + 1]],
+                                     positions[indices[i * 3 + 2]], barycentric, t) || t <= 0.0f) {
+        return false;
+      }
+      hit = t;
+      return true;
+    }, triangle, distance);
+  }
+};
+
+struct SceneObject {
+  glm::mat4 transform;
+  glm::mat4 inverse_transform;
+  const PickMesh *mesh;
+};
+
+struct RayHit {
+  std::uint32_t object = 0;
+  float distance = 0.0f;
+  glm::vec3 position = glm::vec3(0.0f);
+};
+
+// Objects placed in the world, indexed by a hierarchy over their bounds for culling and picking. Objects are
+// added up front and build() indexes them. Moving one afterwards is cheap, update() refits the hierarchy once
+// for everything that moved since the last call
+class Scene {
+
+public:
+  // Returns the new object's id, which is its index in the order objects were added
+  std::uint32_t add(const glm::mat4 &transform, const PickMesh *mesh) {
+    SceneObject object;
+    object.transform = transform;
+    object.inverse_transform = glm::inverse(transform);
+    object.mesh = mesh;
+    objects_.push_back(object);
+    return static_cast<std::uint32_t>(objects_.size() - 1);
+  }
+
+  void set_transform(const std::uint32_t id, const glm::mat4 &transform) {
+    SceneObject &object = objects_[id];
+    object.transform = transform;
+    object.inverse_transform = glm::inverse(transform);
+    hierarchy_.update(id, get_world_bounds(object));
+  }
+
+  const glm::mat4& get_transform(const std::uint32_t id) const {
+    return objects_[id].transform;
+  }
+
+  std::size_t size() const {
+    return objects_.size();
+  }
+
+  const Bvh& get_hierarchy() const {
+    return hierarchy_;
+  }
+
+  void build() {
+    std::vector<Aabb> bounds(objects_.size());
+    for (std::size_t i = 0; i < objects_.size(); i++) {
+      bounds[i] = get_world_bounds(objects_[i]);
+    }
+    hierarchy_.build(bounds);
+  }
+
+  void update() {
+    hierarchy_.refit();
+  }
+
+  // Appends the id of every object whose bounds intersect the frustum
+  template <typename Allocator>
+  void cull(const Frustum &frustum, std::vector<std::uint32_t, Allocator> &visible) const {
+    hierarchy_.cull(frustum, visible);
+  }
+
+  // Closest object along a world space ray. Distance is in units of the direction's length
+  bool pick(const glm::vec3 &origin, const glm::vec3 &direction, RayHit &hit) const {
+    std::uint32_t object = 0;
+    float distance = 0.0f;
+    const bool found = hierarchy_.raycast(origin, direction, [this, &origin, &direction](const std::uint32_t i,
+                                                                                          float &t) {
+      // Moved into the object's space with the direction left unnormalized, distances come out the same
+      const SceneObject &candidate = objects_[i];
+      const glm::vec3 local_origin = glm::vec3(candidate.inverse_transform * glm::vec4(origin, 1.0f));
+      const glm::vec3 local_direction = glm::mat3(candidate.inverse_transform) * direction;
+      return candidate.mesh->raycast(local_origin, local_direction, t);
+    }, object, distance);
+    if (!found) {
+      return false;
+    }
+
+    hit.object = object;
+    hit.distance = distance;
+    hit.position = origin + direction * distance;
+    return true;
+  }
+
+private:
+  static Aabb get_world_bounds(const SceneObject &object) {
+    return Aabb::transformed(object.transform, object.mesh->bounds.min, object.mesh->bounds.max);
+  }
+
+  std::vector<SceneObject> objects_;
+  Bvh hierarchy_;
+};
+
+#endif /* scene_h */
@@ -1,144 +1,53 @@
 #version 330 core
 out vec4 FragColor;
 
+#include "lights.glsl"
+
 struct Material {
   sampler2D diffuse;
   sampler2D specular;
   float shininess;
 };
 
-struct DirLight {
-  vec3 direction;
-
-  vec3 ambient;
-  vec3 diffuse;
-  vec3 specular;
-};
-
-struct PointLight {
-  vec3 position;
-  
-  float constant;
-  float linear;
-  float quadratic;
-
-  vec3 ambient;
-  vec3 diffuse;
-  vec3 specular;
-};
-
-struct SpotLight {
-  vec3 position;
-  vec3 direction;
-  float cutOff;
-  float outerCutOff;
-
-  float constant;
-  float linear;
-  float quadratic;
-
-  vec3 ambient;
-  vec3 diffuse;
-  vec3 specular;
-};
-
-#define NR_POINT_LIGHTS 4
-
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 
-uniform vec3 viewPos;
-uniform DirLight dirLight;
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform SpotLight spotLight;
 uniform Material material;
 
-// function prototypes
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-
 void main() {
   // Properties
   vec3 norm = normalize(Normal);
   vec3 viewDir = normalize(viewPos - FragPos);
+#ifdef SPECULAR_MAP
+  vec3 specular = vec3(texture(material.specular, TexCoords));
+#else
+  // Materials without a specular map are matte
+  vec3 specular = vec3(0.0);
+#endif
+  Surface surface = Surface(vec3(texture(material.diffuse, TexCoords)), specular, material.shininess);
   
   // == =====================================================
   // Our lighting is set up in 3 phases: directional, point lights and an optional flashlight
   // For each phase, a calculate function is defined that calculates the corresponding color
   // per lamp. In the main() function we take all the calculated colors and sum them up for
-  // this fragment's final color.
+  // this fragment's final color. Variants built without POINT_LIGHTS or SPOT_LIGHT skip
+  // those phases, see shader_library.hpp
   // == =====================================================
   // Phase 1: directional lighting
-  vec3 result = CalcDirLight(dirLight, norm, viewDir);
-  // Phase 2: point lights
-  for (int i = 0; i < NR_POINT_LIGHTS; i++) {
-    result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
+  vec3 result = CalcDirLight(dirLight, surface, norm, viewDir);
+#ifdef POINT_LIGHTS
+  // Phase 2: point lights, only the ones that reach this fragment's cluster
+  uvec2 range = texelFetch(clusterRanges, int(FindCluster(FragPos))).xy;
+  for (uint i = 0u; i < range.y; i++) {
+    int index = int(texelFetch(clusterIndices, int(range.x + i)).x);
+    result += CalcPointLight(FetchPointLight(index), surface, norm, FragPos, viewDir);
   }
+#endif
+#ifdef SPOT_LIGHT
   // Phase 3: spot light
-  result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+  result += CalcSpotLight(spotLight, surface, norm, FragPos, viewDir);
+#endif
   
   FragColor = vec4(result, 1.0);
 }
-
-// calculates the color when using a directional light.
-vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir) {
-  vec3 lightDir = normalize(-light.direction);
-  // diffuse shading
-  float diff = max(dot(normal, lightDir), 0.0);
-  // specular shading
-  vec3 reflectDir = reflect(-lightDir, normal);
-  float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-  // combine results
-  vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-  vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-  vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-  return (ambient + diffuse + specular);
-}
-
-// Calculates the color when using a point light.
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-  vec3 lightDir = normalize(light.position - fragPos);
-  // Diffuse shading
-  float diff = max(dot(normal, lightDir), 0.0);
-  // Specular shading
-  vec3 reflectDir = reflect(-lightDir, normal);
-  float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-  // Attenuation
-  float distance = length(light.position - fragPos);
-  float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-  // Combine results
-  vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-  vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-  vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-  ambient *= attenuation;
-  diffuse *= attenuation;
-  specular *= attenuation;
-  return (ambient + diffuse + specular);
-}
-
-// Calculates the color when using a spot light.
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-  vec3 lightDir = normalize(light.position - fragPos);
-  // Diffuse shading
-  float diff = max(dot(normal, lightDir), 0.0);
-  // Specular shading
-  vec3 reflectDir = reflect(-lightDir, normal);
-  float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-  // Attenuation
-  float distance = length(light.position - fragPos);
-  float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-  // Spotlight intensity
-  float theta = dot(lightDir, normalize(-light.direction));
-  float epsilon = light.cutOff - light.outerCutOff;
-  float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-  // Combine results
-  vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoords));
-  vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoords));
-  vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-  ambient *= attenuation * intensity;
-  diffuse *= attenuation * intensity;
-  specular *= attenuation * intensity;
-  return (ambient + diffuse + specular);
-}
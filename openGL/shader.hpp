@@ -10,144 +10,400 @@
 #define shader_h
 
 // System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 // Local Includes
+#include "gl_state_cache.hpp"
+#include "program_cache.hpp"
+#include "shader_source.hpp"
+#include "render_stats.hpp"
 #include "glm/glm.hpp"
 
-class Shader {
+// Upload helpers shared by the by-name setters and the typed handles
+inline void upload_uniform(const int location, const bool value) {
+  ++render_stats().uniform_calls;
+  glUniform1i(location, static_cast<int>(value));
+}
+
+inline void upload_uniform(const int location, const int value) {
+  ++render_stats().uniform_calls;
+  glUniform1i(location, value);
+}
+
+inline void upload_uniform(const int location, const float value) {
+  ++render_stats().uniform_calls;
+  glUniform1f(location, value);
+}
+
+inline void upload_uniform(const int location, const glm::vec2 &value) {
+  ++render_stats().uniform_calls;
+  glUniform2fv(location, 1, &value[0]);
+}
+
+inline void upload_uniform(const int location, const glm::vec3 &value) {
+  ++render_stats().uniform_calls;
+  glUniform3fv(location, 1, &value[0]);
+}
+
+inline void upload_uniform(const int location, const glm::vec4 &value) {
+  ++render_stats().uniform_calls;
+  glUniform4fv(location, 1, &value[0]);
+}
+
+inline void upload_uniform(const int location, const glm::mat2 &mat) {
+  ++render_stats().uniform_calls;
+  glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+inline void upload_uniform(const int location, const glm::mat3 &mat) {
+  ++render_stats().uniform_calls;
+  glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+inline void upload_uniform(const int location, const glm::mat4 &mat) {
+  ++render_stats().uniform_calls;
+  glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+}
+
+// A uniform location resolved once up front. Setting it costs a single glUniform call and no lookup.
+// Like the by-name setters it applies to whichever program is currently in use
+template <typename T>
+class UniformHandle {
 
 public:
-  // Ctor
-  Shader(const char *vertexPath, const char *fragmentPath) {
-    // Retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-
-    // Ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-      // Open files
-      vShaderFile.open(vertexPath);
-      fShaderFile.open(fragmentPath);
-      std::stringstream vShaderStream, fShaderStream;
-      
-      // Read file's buffer contents into streams
-      vShaderStream << vShaderFile.rdbuf();
-      fShaderStream << fShaderFile.rdbuf();
-      
-      // Close file handlers
-      vShaderFile.close();
-      fShaderFile.close();
-      
-      // Convert stream into string
-      vertexCode = vShaderStream.str();
-      fragmentCode = fShaderStream.str();
+  UniformHandle() = default;
+
+  explicit UniformHandle(const int location)
+  : location_(location) {}
+
+  void set(const T &value) const {
+    upload_uniform(location_, value);
+  }
+
+  bool is_valid() const {
+    return location_ != -1;
+  }
+
+  int get_location() const {
+    return location_;
+  }
+
+private:
+  int location_ = -1;
+};
+
+// Open addressing table of the program's active uniforms, built once at link time
+class UniformTable {
+
+public:
+  void insert(const std::string &name, const int location) {
+    if ((count_ + 1) * 2 > slots_.size()) {
+      grow();
     }
-    catch (std::ifstream::failure& e) {
-      std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+    place(Slot{name, location, hash(name.c_str())});
+    ++count_;
+  }
+
+  // Returns -1 for names that are not active in the program, same as glGetUniformLocation
+  int find(const char *name) const {
+    if (slots_.empty()) {
+      return -1;
     }
 
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
+    const std::uint32_t h = hash(name);
+    const std::size_t mask = slots_.size() - 1;
+    for (std::size_t i = h & mask; ; i = (i + 1) & mask) {
+      const Slot &slot = slots_[i];
+      if (slot.name.empty()) {
+        return -1;
+      }
+      if (slot.hash == h && std::strcmp(slot.name.c_str(), name) == 0) {
+        return slot.location;
+      }
+    }
+  }
 
-    // Compile shaders
-    
-    // Vertex shader
-    const unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    check_compile_errors(vertex, "VERTEX");
-    
-    // Fragment Shader
-    const unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    check_compile_errors(fragment, "FRAGMENT");
+  std::size_t size() const {
+    return count_;
+  }
+
+private:
+  struct Slot {
+    std::string name;
+    int location = -1;
+    std::uint32_t hash = 0;
+  };
+
+  // FNV-1a
+  static std::uint32_t hash(const char *name) {
+    std::uint32_t h = 2166136261u;
+    for (; *name != '\0'; ++name) {
+      h = (h ^ static_cast<unsigned char>(*name)) * 16777619u;
+    }
+    return h;
+  }
+
+  void place(Slot slot) {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t i = slot.hash & mask;
+    while (!slots_[i].name.empty()) {
+      i = (i + 1) & mask;
+    }
+    slots_[i] = std::move(slot);
+  }
+
+  void grow() {
+    std::vector<Slot> old(slots_.empty() ? 16 : slots_.size() * 2);
+    old.swap(slots_);
+    for (Slot &slot : old) {
+      if (!slot.name.empty()) {
+        place(std::move(slot));
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  std::size_t count_ = 0;
+};
+
+// Adds defines to a shader's source, after the #version line that GLSL insists comes first. A #line directive
+// after them keeps compile errors pointing at the lines of the file
+inline std::string inject_defines(const std::string &source, const std::string &defines) {
+  const std::size_t version = source.find("#version");
+  const std::size_t line_end = version == std::string::npos ? std::string::npos : source.find('\n', version);
+  if (defines.empty() || line_end == std::string::npos) {
+    return defines + source;
+  }
+  const std::size_t next_line = std::count(source.begin(), source.begin() + line_end, '\n') + 2;
+  return source.substr(0, line_end + 1) + defines + "#line " + std::to_string(next_line) + "\n" +
+         source.substr(line_end + 1);
+}
+
+class Shader {
+
+public:
+  // Ctor. The defines, if any, are added to both sources. Unless told not to wait, the program is ready to use
+  // once constructed. Otherwise the driver may still be building it until finish() is called, which leaves it
+  // free to build many programs at once
+  Shader(const char *vertexPath, const char *fragmentPath, const std::string &defines = std::string(),
+         const bool wait = true) {
+    const auto start = std::chrono::steady_clock::now();
     
-    // Shader Program
+    // Retrieve the vertex/fragment source code from filePath, along with everything they include
+    ShaderSource vertexSource;
+    ShaderSource fragmentSource;
+    if (!load_shader_source(vertexPath, vertexSource) || !load_shader_source(fragmentPath, fragmentSource)) {
+      std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+    }
+    const std::string vertexCode = inject_defines(vertexSource.text, defines);
+    const std::string fragmentCode = inject_defines(fragmentSource.text, defines);
+    files_ = vertexSource.files;
+    vertex_file_count_ = files_.size();
+    files_.insert(files_.end(), fragmentSource.files.begin(), fragmentSource.files.end());
+
+    // A binary cached by an earlier run skips compiling and linking altogether. Anything off about it, down to
+    // the driver refusing it, falls back to building from source, which then replaces the cached binary
+    cached_ = program_cache().enabled && is_program_binary_supported();
+    source_hash_ = cached_ ? hash_program_sources({&vertexCode, &fragmentCode}) : 0;
+    cache_path_ = get_program_cache_path(vertexPath, fragmentPath, defines);
     id_ = glCreateProgram();
-    glAttachShader(id_, vertex);
-    glAttachShader(id_, fragment);
-    glLinkProgram(id_);
-    check_compile_errors(id_, "PROGRAM");
+    bool rejected = false;
+    if (cached_ && load_program_binary(cache_path_, source_hash_, id_, rejected)) {
+      ++program_cache().loaded;
+      reflect_uniforms();
+      finished_ = true;
+    }
+    else {
+      if (rejected) {
+        ++program_cache().rejected;
+        glDeleteProgram(id_);
+        id_ = glCreateProgram();
+      }
+      build(vertexCode.c_str(), fragmentCode.c_str());
+      ++program_cache().compiled;
+    }
     
-    // Delete the shaders after linking
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+    program_cache().seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (wait) {
+      finish();
+    }
   }
   
   // Dtor
   ~Shader() {
+    if (!finished_) {
+      glDeleteShader(vertex_);
+      glDeleteShader(fragment_);
+    }
+    gl_state().forget_program(id_);
     glDeleteProgram(id_);
   }
+  
+  Shader(const Shader&) = delete;
+  Shader& operator=(const Shader&) = delete;
+  
+  // Waits for the driver to finish building the program, reports what went wrong and caches the binary. Does
+  // nothing once the program is ready
+  void finish() {
+    if (finished_) {
+      return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<std::string> vertex_files(files_.begin(), files_.begin() + vertex_file_count_);
+    const std::vector<std::string> fragment_files(files_.begin() + vertex_file_count_, files_.end());
+    check_compile_errors(vertex_, "VERTEX", vertex_files);
+    check_compile_errors(fragment_, "FRAGMENT", fragment_files);
+    check_compile_errors(id_, "PROGRAM");
+    
+    // Delete the shaders after linking
+    glDeleteShader(vertex_);
+    glDeleteShader(fragment_);
+    vertex_ = 0;
+    fragment_ = 0;
+    
+    if (cached_ && is_linked()) {
+      write_program_binary(cache_path_, source_hash_, id_);
+    }
+    reflect_uniforms();
+    finished_ = true;
+    program_cache().seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  
+  // Whether finish() has run, or had nothing to do because the program came from the cache
+  bool is_finished() const {
+    return finished_;
+  }
+  
+  // Every file the program was built from, both stages and whatever they include
+  const std::vector<std::string>& get_files() const {
+    return files_;
+  }
 
   void use() {
-    glUseProgram(id_);
+    gl_state().use_program(id_);
   }
   
   unsigned int get_id() const {
     return id_;
   }
   
-  // TODO: might be useful to make sure these are relevant
-  void set_bool(const std::string name, const bool value) {
-    glUniform1i(glGetUniformLocation(id_, name.c_str()), static_cast<int>(value));
+  bool is_linked() const {
+    GLint linked = GL_FALSE;
+    glGetProgramiv(id_, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+  }
+  
+  // Points a uniform block at a buffer binding. Returns false if the program does not declare the block
+  bool bind_uniform_block(const char *block_name, const unsigned int binding) const {
+    const unsigned int index = glGetUniformBlockIndex(id_, block_name);
+    if (index == GL_INVALID_INDEX) {
+      return false;
+    }
+    glUniformBlockBinding(id_, index, binding);
+    return true;
+  }
+  
+  // Resolves a uniform once so it can be set every frame without a lookup
+  template <typename T>
+  UniformHandle<T> get_uniform(const char *name) const {
+    return UniformHandle<T>(find_location(name));
   }
   
-  void set_int(const std::string name, const int value) {
-    glUniform1i(glGetUniformLocation(id_, name.c_str()), value);
+  // By-name setters. Each call is a lookup in the reflected table, so prefer handles on the hot path
+  void set_bool(const char *name, const bool value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_float(const std::string name, const float value) {
-    glUniform1f(glGetUniformLocation(id_, name.c_str()), value);
+  void set_int(const char *name, const int value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_vec2(const std::string &name, const glm::vec2 &value) const {
-      glUniform2fv(glGetUniformLocation(id_, name.c_str()), 1, &value[0]);
+  void set_float(const char *name, const float value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_vec2(const std::string &name, float x, float y) const {
-      glUniform2f(glGetUniformLocation(id_, name.c_str()), x, y);
+  void set_vec2(const char *name, const glm::vec2 &value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_vec3(const std::string &name, const glm::vec3 &value) const {
-      glUniform3fv(glGetUniformLocation(id_, name.c_str()), 1, &value[0]);
+  void set_vec2(const char *name, float x, float y) const {
+    ++render_stats().uniform_calls;
+    glUniform2f(find_location(name), x, y);
   }
   
-  void set_vec3(const std::string &name, float x, float y, float z) const {
-      glUniform3f(glGetUniformLocation(id_, name.c_str()), x, y, z);
+  void set_vec3(const char *name, const glm::vec3 &value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_vec4(const std::string &name, const glm::vec4 &value) const {
-      glUniform4fv(glGetUniformLocation(id_, name.c_str()), 1, &value[0]);
+  void set_vec3(const char *name, float x, float y, float z) const {
+    ++render_stats().uniform_calls;
+    glUniform3f(find_location(name), x, y, z);
   }
   
-  void set_vec4(const std::string &name, float x, float y, float z, float w) const {
-      glUniform4f(glGetUniformLocation(id_, name.c_str()), x, y, z, w);
+  void set_vec4(const char *name, const glm::vec4 &value) const {
+    upload_uniform(find_location(name), value);
   }
   
-  void set_mat2(const std::string &name, const glm::mat2 &mat) const {
-      glUniformMatrix2fv(glGetUniformLocation(id_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  void set_vec4(const char *name, float x, float y, float z, float w) const {
+    ++render_stats().uniform_calls;
+    glUniform4f(find_location(name), x, y, z, w);
+  }
+  
+  void set_mat2(const char *name, const glm::mat2 &mat) const {
+    upload_uniform(find_location(name), mat);
   }
 
-  void set_mat3(const std::string &name, const glm::mat3 &mat) const {
-      glUniformMatrix3fv(glGetUniformLocation(id_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  void set_mat3(const char *name, const glm::mat3 &mat) const {
+    upload_uniform(find_location(name), mat);
+  }
+  
+  void set_mat4(const char *name, const glm::mat4 &mat) const {
+    upload_uniform(find_location(name), mat);
   }
   
-  void set_mat4(const std::string &name, const glm::mat4 &mat) const {
-      glUniformMatrix4fv(glGetUniformLocation(id_, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+  // Number of by-name uniform lookups made by all shaders since the last reset. Reset once per frame
+  static std::size_t get_lookup_count() {
+    return lookup_counter();
+  }
+  
+  static void reset_lookup_count() {
+    lookup_counter() = 0;
   }
 
 private:
-  void check_compile_errors(const unsigned int shader, const std::string type) {
+  // Compiles both stages and links them into the program without asking how that went, which would wait for the
+  // driver. Asking for a retrievable binary up front lets the driver keep what glGetProgramBinary needs
+  void build(const char *vShaderCode, const char *fShaderCode) {
+    // Vertex shader
+    vertex_ = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex_, 1, &vShaderCode, nullptr);
+    glCompileShader(vertex_);
+    
+    // Fragment Shader
+    fragment_ = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment_, 1, &fShaderCode, nullptr);
+    glCompileShader(fragment_);
+    
+    // Shader Program
+    if (cached_) {
+      glProgramParameteri(id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glAttachShader(id_, vertex_);
+    glAttachShader(id_, fragment_);
+    glLinkProgram(id_);
+  }
+  
+  // Compile logs refer to files by their index in the stage's source, see shader_source.hpp, so those are listed
+  void check_compile_errors(const unsigned int shader, const std::string type,
+                            const std::vector<std::string> &files = std::vector<std::string>()) {
     int success;
     char infoLog[1024];
     
@@ -156,7 +412,11 @@ private:
       
       if (!success) {
         glGetShaderInfoLog(shader, 1024, nullptr, infoLog);
-        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n -- --------------------------------------------------- -- " << std::endl;
+        std::cout << "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n" << infoLog << "\n";
+        for (std::size_t i = 0; i < files.size(); i++) {
+          std::cout << "Source " << i << ": " << files[i] << "\n";
+        }
+        std::cout << " -- --------------------------------------------------- -- " << std::endl;
       }
     }
     else {
@@ -169,7 +429,62 @@ private:
     }
   }
   
+  // Records every active uniform location so by-name lookups never reach the driver
+  void reflect_uniforms() {
+    int count = 0;
+    int max_length = 0;
+    glGetProgramiv(id_, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(id_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+    
+    std::vector<char> buffer(static_cast<std::size_t>(max_length) + 1);
+    for (int i = 0; i < count; i++) {
+      int size = 0;
+      GLenum type = 0;
+      glGetActiveUniform(id_, i, max_length, nullptr, &size, &type, buffer.data());
+      
+      std::string name(buffer.data());
+      const int location = glGetUniformLocation(id_, name.c_str());
+      
+      // Members of uniform blocks have no location
+      if (location == -1) {
+        continue;
+      }
+      
+      uniforms_.insert(name, location);
+      
+      // Arrays of basic types are reported once as "name[0]", so also register the bare name and every element
+      const std::size_t bracket = name.rfind("[0]");
+      if (bracket != std::string::npos && bracket + 3 == name.size()) {
+        const std::string base = name.substr(0, bracket);
+        uniforms_.insert(base, location);
+        for (int element = 1; element < size; element++) {
+          const std::string element_name = base + "[" + std::to_string(element) + "]";
+          uniforms_.insert(element_name, glGetUniformLocation(id_, element_name.c_str()));
+        }
+      }
+    }
+  }
+  
+  int find_location(const char *name) const {
+    ++lookup_counter();
+    return uniforms_.find(name);
+  }
+  
+  static std::size_t& lookup_counter() {
+    static std::size_t count = 0;
+    return count;
+  }
+  
   unsigned int id_;
+  unsigned int vertex_ = 0;
+  unsigned int fragment_ = 0;
+  bool finished_ = false;
+  bool cached_ = false;
+  std::uint64_t source_hash_ = 0;
+  std::string cache_path_;
+  std::vector<std::string> files_;
+  std::size_t vertex_file_count_ = 0;
+  UniformTable uniforms_;
   
 };
 
@@ -0,0 +1,25 @@
+#version 330 core
+// Reference variant that inverts the model matrix per vertex, kept to benchmark against shader.vert. aModel
+// includes the mesh dequantization, which would shear normals, so the normal matrix slot carries the model
+// matrix from before that step instead. It is still inverted as a 4x4, the work being measured
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aPlacement;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+
+#include "camera.glsl"
+#include "octahedral.glsl"
+
+void main()
+{
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(mat4(aPlacement)))) * DecodeOctahedral(aNormal);
+    TexCoords = aTexCoords;
+    
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,326 @@
+//
+//  shader_library.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef shader_library_h
+#define shader_library_h
+
+// System Includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Local Includes
+#include "file_watcher.hpp"
+#include "shader.hpp"
+
+// Features a program can be built with or without. Each one is a #define the sources test with #ifdef, so a
+// variant without a feature carries none of its code rather than a branch around it
+const std::uint32_t SHADER_FEATURE_POINT_LIGHTS = 1 << 0;
+const std::uint32_t SHADER_FEATURE_SPOT_LIGHT = 1 << 1;
+const std::uint32_t SHADER_FEATURE_SPECULAR_MAP = 1 << 2;
+
+const std::size_t SHADER_FEATURE_COUNT = 3;
+const std::size_t SHADER_VARIANTS_PER_PROGRAM = 1u << SHADER_FEATURE_COUNT;
+
+// The define of each feature, in bit order
+const char *const SHADER_FEATURE_DEFINES[SHADER_FEATURE_COUNT] = {
+  "POINT_LIGHTS",
+  "SPOT_LIGHT",
+  "SPECULAR_MAP"
+};
+
+// Whether the driver can compile and link in the background and say when it is done, instead of doing all of
+// it on the first call that asks about the result
+inline bool is_parallel_compile_supported() {
+#if !defined(__APPLE__)
+  if (glMaxShaderCompilerThreadsKHR == nullptr) {
+    return false;
+  }
+#endif
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; i++) {
+    const char *name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+    if (name != nullptr && std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Sets up a freshly built variant of a program, its sampler units, block bindings and uniform handles
+using ShaderSetup = std::function<void(std::uint32_t variant, Shader &shader)>;
+
+// Every variant of every program the renderer may draw with. Programs are registered with the features their
+// sources know about, then the variants that can come up are required and all of them are compiled together
+// before the first frame, so nothing is ever compiled while drawing. Variants are numbered in the order they
+// were required, which is what goes into the program field of a sort key.
+// With hot reload on, a variant is rebuilt whenever a file it was built from changes. The rebuild compiles
+// alongside the frames that follow and replaces the variant once it links, under the same number
+class ShaderLibrary {
+
+public:
+  // Registers a program built from one pair of sources and returns its index. features is the set it has
+  // variants for, any other feature asked of it is ignored. setup runs on each variant once it is built
+  std::uint32_t add(const char *vertex_path, const char *fragment_path, const std::uint32_t features,
+                    const ShaderSetup &setup = ShaderSetup()) {
+    Program program;
+    program.vertex_path = vertex_path;
+    program.fragment_path = fragment_path;
+    program.features = features;
+    program.setup = setup;
+    program.variants.fill(-1);
+    programs_.push_back(program);
+    return static_cast<std::uint32_t>(programs_.size() - 1);
+  }
+
+  // Requires, of every program, the variant with the features in always plus any combination of those in
+  // sometimes, which are the ones that can change from draw to draw
+  void require(const std::uint32_t always, const std::uint32_t sometimes) {
+    for (std::uint32_t program = 0; program < programs_.size(); program++) {
+      for (std::uint32_t subset = sometimes; ; subset = (subset - 1) & sometimes) {
+        require_variant(program, always | subset);
+        if (subset == 0) {
+          break;
+        }
+      }
+    }
+  }
+
+  // Starts building every required variant that has not been started yet. Where the driver compiles in the
+  // background this returns long before they are done
+  void compile() {
+    parallel_ = is_parallel_compile_supported();
+    if (parallel_) {
+      glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+    for (std::size_t i = shaders_.size(); i < variants_.size(); i++) {
+      const Variant &variant = variants_[i];
+      const Program &program = programs_[variant.program];
+      shaders_.emplace_back(new Shader(program.vertex_path.c_str(), program.fragment_path.c_str(),
+                                       get_defines(variant.features), false));
+    }
+  }
+
+  // Waits for every variant to be built and sets them up. Returns how many of those the driver had already
+  // finished by itself
+  std::size_t finish() {
+    std::size_t finished = 0;
+    for (std::uint32_t variant = 0; variant < shaders_.size(); variant++) {
+      Shader &shader = *shaders_[variant];
+      if (shader.is_finished()) {
+        ++finished;
+      }
+      else {
+        finished += is_complete(shader) ? 1 : 0;
+        shader.finish();
+      }
+      set_up(variant, shader);
+    }
+    return finished;
+  }
+
+  // Watches every file the variants were built from, so reload() can rebuild them when one changes
+  void watch() {
+    hot_reload_ = true;
+    for (const std::unique_ptr<Shader> &shader : shaders_) {
+      for (const std::string &file : shader->get_files()) {
+        watcher_.watch(file);
+      }
+    }
+  }
+
+  // Call once a frame, before drawing. Starts rebuilding every variant built from a file that changed, and swaps
+  // in the rebuilds that are done. A rebuild that does not compile or link is dropped, and its variant goes on
+  // drawing with what it had. Without parallel compile a rebuild is waited on straight away
+  void reload() {
+    if (!hot_reload_) {
+      return;
+    }
+    changed_.clear();
+    watcher_.poll(changed_);
+    for (const std::string &path : changed_) {
+      rebuild(path);
+    }
+
+    for (std::size_t i = 0; i < rebuilds_.size(); ) {
+      Rebuild &rebuild = rebuilds_[i];
+      if (!is_complete(*rebuild.shader)) {
+        ++i;
+        continue;
+      }
+
+      rebuild.shader->finish();
+      const Program &program = programs_[variants_[rebuild.variant].program];
+      const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                                  rebuild.start).count();
+      if (rebuild.shader->is_linked()) {
+        set_up(rebuild.variant, *rebuild.shader);
+        for (const std::string &file : rebuild.shader->get_files()) {
+          watcher_.watch(file);
+        }
+        shaders_[rebuild.variant] = std::move(rebuild.shader);
+        std::cout << "Reloaded " << program.fragment_path << " variant " << variants_[rebuild.variant].features
+                  << " in " << ms << " ms\n";
+      }
+      else {
+        std::cerr << "Kept the previous " << program.fragment_path << " variant "
+                  << variants_[rebuild.variant].features << ", the edited one does not build\n";
+      }
+      rebuilds_.erase(rebuilds_.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+  }
+
+  // Variant of a program with the given features, for drawing. Variants that were never required fall back to
+  // the program's first, as compiling one now would stall the frame
+  std::uint32_t find(const std::uint32_t program, const std::uint32_t features) const {
+    const Program &entry = programs_[program];
+    const int variant = entry.variants[features & entry.features];
+    if (variant >= 0) {
+      return static_cast<std::uint32_t>(variant);
+    }
+    if (!missing_reported_) {
+      std::cerr << "Variant " << (features & entry.features) << " of " << entry.fragment_path
+                << " was never required\n";
+      missing_reported_ = true;
+    }
+    return static_cast<std::uint32_t>(entry.first_variant);
+  }
+
+  Shader& get(const std::uint32_t variant) {
+    return *shaders_[variant];
+  }
+
+  std::size_t get_program_count() const {
+    return programs_.size();
+  }
+
+  std::size_t get_variant_count() const {
+    return variants_.size();
+  }
+
+  bool is_parallel() const {
+    return parallel_;
+  }
+
+  // Rebuilds started by reload() that have not been swapped in or dropped yet
+  std::size_t get_pending_count() const {
+    return rebuilds_.size();
+  }
+
+  // The defines a variant is built with, one line each
+  static std::string get_defines(const std::uint32_t features) {
+    std::string defines;
+    for (std::size_t i = 0; i < SHADER_FEATURE_COUNT; i++) {
+      if ((features & (1u << i)) != 0) {
+        defines += std::string("#define ") + SHADER_FEATURE_DEFINES[i] + "\n";
+      }
+    }
+    return defines;
+  }
+
+private:
+  struct Program {
+    std::string vertex_path;
+    std::string fragment_path;
+    std::uint32_t features = 0;
+    std::array<int, SHADER_VARIANTS_PER_PROGRAM> variants;
+    int first_variant = -1;
+    ShaderSetup setup;
+  };
+
+  struct Variant {
+    std::uint32_t program;
+    std::uint32_t features;
+  };
+
+  struct Rebuild {
+    std::uint32_t variant;
+    std::unique_ptr<Shader> shader;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // Whether the driver is done building, which is always the case for the caller without parallel compile
+  // since asking for the result waits
+  bool is_complete(const Shader &shader) const {
+    if (!parallel_ || shader.is_finished()) {
+      return true;
+    }
+    GLint complete = GL_FALSE;
+    glGetProgramiv(shader.get_id(), GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+  }
+
+  void set_up(const std::uint32_t variant, Shader &shader) {
+    const ShaderSetup &setup = programs_[variants_[variant].program].setup;
+    if (setup) {
+      setup(variant, shader);
+    }
+  }
+
+  // Starts a new build of every variant that uses path. One still building from an earlier change is replaced
+  void rebuild(const std::string &path) {
+    for (std::uint32_t variant = 0; variant < shaders_.size(); variant++) {
+      const std::vector<std::string> &files = shaders_[variant]->get_files();
+      if (std::find(files.begin(), files.end(), path) == files.end()) {
+        continue;
+      }
+
+      const Program &program = programs_[variants_[variant].program];
+      Rebuild rebuild;
+      rebuild.variant = variant;
+      rebuild.start = std::chrono::steady_clock::now();
+      rebuild.shader.reset(new Shader(program.vertex_path.c_str(), program.fragment_path.c_str(),
+                                      get_defines(variants_[variant].features), false));
+      bool replaced = false;
+      for (Rebuild &pending : rebuilds_) {
+        if (pending.variant == variant) {
+          pending = std::move(rebuild);
+          replaced = true;
+          break;
+        }
+      }
+      if (!replaced) {
+        rebuilds_.push_back(std::move(rebuild));
+      }
+    }
+  }
+
+  void require_variant(const std::uint32_t program, const std::uint32_t features) {
+    Program &entry = programs_[program];
+    const std::uint32_t masked = features & entry.features;
+    if (entry.variants[masked] >= 0) {
+      return;
+    }
+    entry.variants[masked] = static_cast<int>(variants_.size());
+    if (entry.first_variant < 0) {
+      entry.first_variant = entry.variants[masked];
+    }
+    variants_.push_back(Variant{program, masked});
+  }
+
+  std::vector<Program> programs_;
+  std::vector<Variant> variants_;
+  std::vector<std::unique_ptr<Shader>> shaders_;
+  std::vector<Rebuild> rebuilds_;
+  FileWatcher watcher_;
+  std::vector<std::string> changed_;
+  bool hot_reload_ = false;
+  bool parallel_ = false;
+  mutable bool missing_reported_ = false;
+};
+
+#endif /* shader_library_h */
@@ -0,0 +1,93 @@
+//
+//  shader_source.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef shader_source_h
+#define shader_source_h
+
+// System Includes
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// A shader stage's source with every #include resolved, along with the files it was put together from, the
+// stage's own file first. GLSL numbers source strings for its error messages, and #line directives make that
+// number the file's index here, so "1:23" in a compile log means line 23 of files[1]
+struct ShaderSource {
+  std::string text;
+  std::vector<std::string> files;
+};
+
+// Directory part of a path, with its trailing slash, or nothing for a bare file name
+inline std::string get_directory(const std::string &path) {
+  const std::size_t slash = path.find_last_of("/\\");
+  return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// Appends path to source, replacing every line of the form #include "name" with the file it names, relative
+// to the including file. Like #pragma once everywhere, a file already part of the source is not included again,
+// so shared structs can be included by every file that needs them. Fails on missing files and include cycles
+inline bool append_shader_file(const std::string &path, ShaderSource &source, std::vector<std::string> &stack) {
+  if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+    std::cerr << "Shader include cycle through " << path << "\n";
+    return false;
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "Failed to read shader " << path << "\n";
+    return false;
+  }
+  const std::size_t index = source.files.size();
+  source.files.push_back(path);
+  stack.push_back(path);
+
+  std::string line;
+  std::size_t line_number = 0;
+  while (std::getline(file, line)) {
+    ++line_number;
+    const std::size_t start = line.find_first_not_of(" \t");
+    if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+      source.text += line;
+      source.text += '\n';
+      continue;
+    }
+
+    const std::size_t open = line.find('"', start + 8);
+    const std::size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+    if (close == std::string::npos) {
+      std::cerr << path << ":" << line_number << ": expected #include \"file\"\n";
+      return false;
+    }
+    const std::string included = get_directory(path) + line.substr(open + 1, close - open - 1);
+    if (std::find(source.files.begin(), source.files.end(), included) != source.files.end()) {
+      source.text += '\n';
+      continue;
+    }
+
+    source.text += "#line 1 " + std::to_string(source.files.size()) + "\n";
+    if (!append_shader_file(included, source, stack)) {
+      return false;
+    }
+    source.text += "#line " + std::to_string(line_number + 1) + " " + std::to_string(index) + "\n";
+  }
+
+  stack.pop_back();
+  return true;
+}
+
+// Reads a shader stage from path and everything it includes
+inline bool load_shader_source(const std::string &path, ShaderSource &source) {
+  source = ShaderSource();
+  std::vector<std::string> stack;
+  return append_shader_file(path, source, stack);
+}
+
+#endif /* shader_source_h */
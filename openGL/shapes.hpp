@@ -0,0 +1,63 @@
+//
+//  shapes.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef shapes_h
+#define shapes_h
+
+// System Includes
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Local Includes
+#include "vertex_format.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
+
+// A unit sphere as a non-indexed triangle list, rings from pole to pole and segments around. Each ring is turned
+// by twist radians more than the one above, which changes the triangles but keeps every vertex on the sphere.
+// Few rings and segments give faceted shapes, from a double pyramid up
+inline std::vector<Vertex> build_sphere(const std::size_t rings, const std::size_t segments, const float twist) {
+  const auto vertex = [&](const std::size_t ring, const std::size_t segment) {
+    const float theta = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(rings);
+    const float phi = 2.0f * glm::pi<float>() * static_cast<float>(segment) / static_cast<float>(segments) +
+                      twist * static_cast<float>(ring);
+    Vertex v;
+    v.position = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+    v.normal = v.position;
+    v.tex_coords = glm::vec2(static_cast<float>(segment) / static_cast<float>(segments),
+                             static_cast<float>(ring) / static_cast<float>(rings));
+    return v;
+  };
+
+  std::vector<Vertex> triangles;
+  triangles.reserve(rings * segments * 6);
+  for (std::size_t ring = 0; ring < rings; ring++) {
+    for (std::size_t segment = 0; segment < segments; segment++) {
+      const Vertex top_left = vertex(ring, segment);
+      const Vertex top_right = vertex(ring, segment + 1);
+      const Vertex bottom_left = vertex(ring + 1, segment);
+      const Vertex bottom_right = vertex(ring + 1, segment + 1);
+
+      // The quads touching a pole have collapsed into triangles
+      if (ring + 1 < rings) {
+        triangles.push_back(top_left);
+        triangles.push_back(bottom_left);
+        triangles.push_back(bottom_right);
+      }
+      if (ring > 0) {
+        triangles.push_back(top_left);
+        triangles.push_back(bottom_right);
+        triangles.push_back(top_right);
+      }
+    }
+  }
+  return triangles;
+}
+
+#endif /* shapes_h */
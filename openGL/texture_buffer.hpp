@@ -0,0 +1,79 @@
+//
+//  texture_buffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef texture_buffer_h
+#define texture_buffer_h
+
+// System Includes
+#include <cstddef>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "render_stats.hpp"
+
+// A buffer object read by shaders through a buffer texture, as a plain array of texels in the given format.
+// Unlike a uniform block it holds as much as the driver allows, GL_MAX_TEXTURE_BUFFER_SIZE texels
+class TextureBuffer {
+
+public:
+  // Ctor
+  explicit TextureBuffer(const GLenum internal_format) {
+    glGenBuffers(1, &buffer_);
+    gl_state().bind_buffer(GL_TEXTURE_BUFFER, buffer_);
+    glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+    capacity_ = 16;
+
+    glGenTextures(1, &texture_);
+    gl_state().bind_texture(GL_TEXTURE_BUFFER, texture_);
+    glTexBuffer(GL_TEXTURE_BUFFER, internal_format, buffer_);
+  }
+
+  // Dtor
+  ~TextureBuffer() {
+    gl_state().forget_texture(texture_);
+    gl_state().forget_buffer(buffer_);
+    glDeleteTextures(1, &texture_);
+    glDeleteBuffers(1, &buffer_);
+  }
+
+  TextureBuffer(const TextureBuffer&) = delete;
+  TextureBuffer& operator=(const TextureBuffer&) = delete;
+
+  // Replaces the contents. The old storage is orphaned so the copy never waits on draws still reading it
+  void upload(const void *data, const std::size_t bytes) {
+    if (bytes == 0) {
+      return;
+    }
+
+    ++render_stats().uniform_calls;
+    gl_state().bind_buffer(GL_TEXTURE_BUFFER, buffer_);
+    if (bytes > capacity_) {
+      capacity_ = bytes + bytes / 2;
+    }
+    glBufferData(GL_TEXTURE_BUFFER, capacity_, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+  }
+
+  void bind(const unsigned int unit) const {
+    gl_state().bind_texture(unit, GL_TEXTURE_BUFFER, texture_);
+  }
+
+  // Texels a buffer texture may hold on this context
+  static std::size_t get_max_texels() {
+    GLint texels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &texels);
+    return static_cast<std::size_t>(texels);
+  }
+
+private:
+  unsigned int buffer_ = 0;
+  unsigned int texture_ = 0;
+  std::size_t capacity_ = 0;
+};
+
+#endif /* texture_buffer_h */
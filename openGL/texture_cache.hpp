@@ -0,0 +1,307 @@
+//
+//  texture_cache.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef texture_cache_h
+#define texture_cache_h
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "image_decoder.hpp"
+#include "ktx.hpp"
+#include "texture_uploader.hpp"
+
+// A GL texture object owned by the cache. Deleted once neither the cache nor any handle references it.
+// Textures acquired asynchronously hold a placeholder until ready, the id stays the same when the image lands
+struct Texture {
+  unsigned int id = 0;
+  int width = 0;
+  int height = 0;
+  std::size_t bytes = 0;
+  bool ready = false;
+};
+
+// Ref-counted handle handed out by the cache. Holding one pins the texture so it is never evicted
+using TextureHandle = std::shared_ptr<const Texture>;
+
+struct TextureCacheStats {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+  std::size_t resident_bytes = 0;
+  std::size_t resident_textures = 0;
+  std::size_t pending_textures = 0;
+  std::size_t uploaded_bytes = 0;
+};
+
+// Default budget of 256 MB of texture memory
+const std::size_t TEXTURE_CACHE_BUDGET = 256u * 1024u * 1024u;
+
+// Default amount of decoded pixels uploaded per frame, 8 MB
+const std::size_t TEXTURE_UPLOAD_BUDGET = 8u * 1024u * 1024u;
+
+// Mid grey, so lighting still reads correctly while the real texture is on its way
+const unsigned char TEXTURE_PLACEHOLDER[4] = {128, 128, 128, 255};
+
+// Caches decoded and uploaded textures by path. Each file is decoded once; textures nobody holds a handle to
+// are evicted least recently used first whenever the resident size goes over budget. Files can be decoded
+// synchronously or on the decoder's worker threads, in which case update() uploads them as they come in.
+// A KTX file next to the image (container2.ktx for container2.png) is used instead when the GPU supports its
+// compressed format, see tools/compress_textures.cpp
+class TextureCache {
+
+public:
+  // Ctor
+  explicit TextureCache(const std::size_t budget_bytes = TEXTURE_CACHE_BUDGET)
+  : budget_bytes_(budget_bytes) {
+    int count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    compressed_formats_.resize(static_cast<std::size_t>(count));
+    if (count > 0) {
+      glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, compressed_formats_.data());
+    }
+
+    // RGTC is core since 3.0 but drivers are allowed to leave it out of the list above
+    compressed_formats_.push_back(static_cast<int>(KTX_COMPRESSED_RG_RGTC2));
+  }
+
+  TextureCache(const TextureCache&) = delete;
+  TextureCache& operator=(const TextureCache&) = delete;
+
+  // Returns the texture for path, loading it on first use. Returns nullptr if the file could not be decoded.
+  // A texture acquire_async() is still loading is waited for and uploaded first, the caller gets it ready either way
+  TextureHandle acquire(const std::string &path) {
+    TextureHandle cached = find(path);
+    if (cached != nullptr) {
+      if (!cached->ready && !wait_for(path)) {
+        return nullptr;
+      }
+      return cached;
+    }
+
+    DecodedImage image = decode_image(path, resolve_source(path));
+    if (!image.is_valid()) {
+      std::cerr << "Texture failed to load at path: " << path << "\n";
+      return nullptr;
+    }
+
+    std::shared_ptr<Texture> texture = create();
+    insert(path, texture);
+    finish(*texture, image);
+    return texture;
+  }
+
+  // Returns the texture for path straight away. A new one shows a placeholder until its file has been decoded on
+  // a worker thread and uploaded by update()
+  TextureHandle acquire_async(const std::string &path) {
+    TextureHandle cached = find(path);
+    if (cached != nullptr) {
+      return cached;
+    }
+
+    std::shared_ptr<Texture> texture = create();
+    insert(path, texture);
+    ++stats_.pending_textures;
+    decoder_.submit(path, resolve_source(path));
+    return texture;
+  }
+
+  // Uploads decoded images until budget_bytes have gone out this frame. Always uploads at least one, so images
+  // larger than the budget still make progress. Call once per frame on the render thread
+  void update(const std::size_t budget_bytes = TEXTURE_UPLOAD_BUDGET) {
+    std::size_t uploaded = 0;
+    DecodedImage image;
+    while (uploaded < budget_bytes && decoder_.try_pop(image)) {
+      uploaded += receive(image);
+    }
+    evict();
+  }
+
+  // True while some acquire_async() texture is still showing its placeholder
+  bool is_loading() const {
+    return stats_.pending_textures > 0;
+  }
+
+  // Drops every texture no handle refers to anymore
+  void trim() {
+    evict_until(0);
+  }
+
+  void set_budget(const std::size_t budget_bytes) {
+    budget_bytes_ = budget_bytes;
+    evict();
+  }
+
+  const TextureCacheStats& get_stats() const {
+    return stats_;
+  }
+
+  void print_stats(std::ostream &out) const {
+    out << "TextureCache: " << stats_.hits << " hits, " << stats_.misses << " misses, "
+        << stats_.evictions << " evictions, " << stats_.resident_textures << " textures resident ("
+        << stats_.resident_bytes / 1024 << " KB of " << budget_bytes_ / 1024 << " KB), "
+        << stats_.pending_textures << " pending, " << stats_.uploaded_bytes / 1024 << " KB uploaded\n";
+  }
+
+private:
+  struct Entry {
+    std::shared_ptr<Texture> texture;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  // The compressed version of path if there is one the GPU can sample, otherwise path itself. Only reads the
+  // KTX header, the rest of the file is left to the decoder
+  std::string resolve_source(const std::string &path) const {
+    const std::size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) {
+      return path;
+    }
+
+    const std::string ktx_path = path.substr(0, dot) + ".ktx";
+    KtxHeader header;
+    if (!read_ktx_header(ktx_path, header)) {
+      return path;
+    }
+    for (const int format : compressed_formats_) {
+      if (static_cast<std::uint32_t>(format) == header.gl_internal_format) {
+        return ktx_path;
+      }
+    }
+    return path;
+  }
+
+  TextureHandle find(const std::string &path) {
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    ++stats_.hits;
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    return it->second.texture;
+  }
+
+  void insert(const std::string &path, const std::shared_ptr<Texture> &texture) {
+    lru_.push_front(path);
+    entries_.emplace(path, Entry{texture, lru_.begin()});
+    stats_.resident_bytes += texture->bytes;
+    ++stats_.resident_textures;
+  }
+
+  void evict() {
+    evict_until(budget_bytes_);
+  }
+
+  // Walks from the least recently used end and releases unpinned textures until resident size fits the limit
+  void evict_until(const std::size_t limit) {
+    auto it = lru_.end();
+    while (stats_.resident_bytes > limit && it != lru_.begin()) {
+      --it;
+      auto entry = entries_.find(*it);
+
+      // Only the cache holds it, so nothing is drawing with it
+      if (entry->second.texture.use_count() == 1) {
+        stats_.resident_bytes -= entry->second.texture->bytes;
+        --stats_.resident_textures;
+        ++stats_.evictions;
+        entries_.erase(entry);
+        it = lru_.erase(it);
+      }
+    }
+  }
+
+  // Puts a decoded image in place of its placeholder and returns the bytes uploaded
+  std::size_t receive(const DecodedImage &image) {
+    --stats_.pending_textures;
+
+    // Evicted while it was being decoded, so nobody wants it anymore
+    auto it = entries_.find(image.path);
+    if (it == entries_.end() || it->second.texture->ready) {
+      return 0;
+    }
+    if (!image.is_valid()) {
+      std::cerr << "Texture failed to load at path: " << image.path << "\n";
+      return 0;
+    }
+
+    finish(*it->second.texture, image);
+    return image.get_bytes();
+  }
+
+  // Takes in decoded images as the workers finish them, uploads included, until the one for path has come. Returns
+  // false if it could not be decoded, or was not being decoded at all because an earlier attempt failed
+  bool wait_for(const std::string &path) {
+    DecodedImage image;
+    while (decoder_.pop(image)) {
+      receive(image);
+      if (image.path == path) {
+        return image.is_valid();
+      }
+    }
+    return false;
+  }
+
+  // A new texture object holding the 1x1 placeholder
+  static std::shared_ptr<Texture> create() {
+    std::shared_ptr<Texture> texture(new Texture, [](Texture *t) {
+      gl_state().forget_texture(t->id);
+      glDeleteTextures(1, &t->id);
+      delete t;
+    });
+    texture->width = 1;
+    texture->height = 1;
+    texture->bytes = sizeof(TEXTURE_PLACEHOLDER);
+
+    glGenTextures(1, &texture->id);
+    gl_state().bind_texture(GL_TEXTURE_2D, texture->id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, TEXTURE_PLACEHOLDER);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+  }
+
+  // Replaces the placeholder with the decoded image
+  void finish(Texture &texture, const DecodedImage &image) {
+    uploader_.upload(texture.id, image);
+
+    // Compressed images come with their mip chain, a generated one adds a third on top of the base level
+    const std::size_t base_bytes = image.get_bytes();
+    stats_.resident_bytes -= texture.bytes;
+    texture.width = image.width;
+    texture.height = image.height;
+    texture.bytes = image.is_compressed() ? base_bytes : base_bytes + base_bytes / 3;
+    texture.ready = true;
+    stats_.resident_bytes += texture.bytes;
+    stats_.uploaded_bytes += base_bytes;
+  }
+
+  std::unordered_map<std::string, Entry> entries_;
+  std::list<std::string> lru_;
+  TextureCacheStats stats_;
+  std::size_t budget_bytes_ = 0;
+  std::vector<int> compressed_formats_;
+
+  TextureUploader uploader_;
+
+  // Declared last so its workers are stopped and joined first
+  ImageDecoder decoder_;
+};
+
+#endif /* texture_cache_h */
@@ -0,0 +1,132 @@
+//
+//  texture_uploader.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef texture_uploader_h
+#define texture_uploader_h
+
+// System Includes
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Local Includes
+#include "gl_state_cache.hpp"
+#include "image_decoder.hpp"
+
+// Uploads decoded and compressed images through a ring of pixel unpack buffers. glTexImage2D sources from the
+// buffer instead of client memory, so it returns as soon as the pixels are copied into the buffer and the
+// transfer to the texture runs alongside rendering. Rotating between buffers keeps one upload from waiting on the previous one
+class TextureUploader {
+
+public:
+  static const std::size_t PBO_COUNT = 3;
+
+  // Ctor
+  TextureUploader() {
+    glGenBuffers(PBO_COUNT, pbos_);
+  }
+
+  // Dtor
+  ~TextureUploader() {
+    for (const unsigned int pbo : pbos_) {
+      gl_state().forget_buffer(pbo);
+    }
+    glDeleteBuffers(PBO_COUNT, pbos_);
+  }
+
+  TextureUploader(const TextureUploader&) = delete;
+  TextureUploader& operator=(const TextureUploader&) = delete;
+
+  // Replaces the contents of texture with image. Uncompressed images get a generated mip chain, compressed ones
+  // bring their own
+  void upload(const unsigned int texture, const DecodedImage &image) {
+    const std::size_t bytes = image.get_bytes();
+    gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, pbos_[next_]);
+    next_ = (next_ + 1) % PBO_COUNT;
+
+    // Orphan the previous storage in case the GPU is still reading from it
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    unsigned char *destination = static_cast<unsigned char*>(
+        glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (destination == nullptr) {
+      // Fall back to a plain upload from client memory
+      gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+
+    gl_state().bind_texture(GL_TEXTURE_2D, texture);
+    if (image.is_compressed()) {
+      upload_compressed(image.compressed, destination);
+    }
+    else {
+      upload_pixels(image, destination);
+    }
+
+    gl_state().bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  }
+
+private:
+  // Copies into the mapped buffer and sources from it, or sources from client memory when it is null
+  static const void* stage(unsigned char *destination, const std::size_t offset, const void *data,
+                           const std::size_t bytes) {
+    if (destination == nullptr) {
+      return data;
+    }
+    std::memcpy(destination + offset, data, bytes);
+    return reinterpret_cast<const void*>(offset);
+  }
+
+  static void upload_pixels(const DecodedImage &image, unsigned char *destination) {
+    const void *source = stage(destination, 0, image.pixels.get(), image.get_bytes());
+    if (destination != nullptr) {
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    GLenum format = GL_RGBA;
+    if (image.components == 1) {
+      format = GL_RED;
+    }
+    else if (image.components == 2) {
+      format = GL_RG;
+    }
+    else if (image.components == 3) {
+      format = GL_RGB;
+    }
+
+    // Rows of 1 and 3 component images are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, source);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+    glGenerateMipmap(GL_TEXTURE_2D);
+  }
+
+  // Every level is staged into the buffer before the first upload reads from it
+  static void upload_compressed(const KtxImage &image, unsigned char *destination) {
+    std::vector<const void*> sources;
+    std::size_t offset = 0;
+    for (const KtxLevel &level : image.levels) {
+      sources.push_back(stage(destination, offset, level.data.data(), level.data.size()));
+      offset += level.data.size();
+    }
+    if (destination != nullptr) {
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    for (std::size_t i = 0; i < image.levels.size(); i++) {
+      const KtxLevel &level = image.levels[i];
+      glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<int>(i), image.internal_format, level.width, level.height,
+                             0, static_cast<GLsizei>(level.data.size()), sources[i]);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(image.levels.size()) - 1);
+  }
+
+  unsigned int pbos_[PBO_COUNT] = {};
+  std::size_t next_ = 0;
+};
+
+#endif /* texture_uploader_h */
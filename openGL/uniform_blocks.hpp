@@ -0,0 +1,87 @@
+//
+//  uniform_blocks.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef uniform_blocks_h
+#define uniform_blocks_h
+
+// System Includes
+#include <cstddef>
+
+// Local Includes
+#include "glm/glm.hpp"
+
+// C++ mirrors of the std140 blocks declared in the shaders. Every vec3 is followed by a float so that the
+// members line up with std140's 16 byte vec3 alignment without any hidden padding
+
+// Uniform buffer binding points shared by every program
+const unsigned int CAMERA_BLOCK_BINDING = 0;
+const unsigned int LIGHT_BLOCK_BINDING = 1;
+
+struct CameraBlock {
+  glm::mat4 projection;
+  glm::mat4 view;
+  glm::vec3 view_pos;
+  float padding;
+};
+
+struct DirLight {
+  glm::vec3 direction;
+  float padding0;
+  glm::vec3 ambient;
+  float padding1;
+  glm::vec3 diffuse;
+  float padding2;
+  glm::vec3 specular;
+  float padding3;
+};
+
+struct PointLight {
+  glm::vec3 position;
+  float constant;
+  glm::vec3 ambient;
+  float linear;
+  glm::vec3 diffuse;
+  float quadratic;
+  glm::vec3 specular;
+  float radius;
+};
+
+struct SpotLight {
+  glm::vec3 position;
+  float constant;
+  glm::vec3 direction;
+  float linear;
+  glm::vec3 ambient;
+  float quadratic;
+  glm::vec3 diffuse;
+  float cut_off;
+  glm::vec3 specular;
+  float outer_cut_off;
+};
+
+// Point lights are too many for a uniform block, they live in a buffer texture sorted into clusters, see
+// light_clusters.hpp. The block only says how the clusters are laid out
+struct LightBlock {
+  DirLight dir_light;
+  SpotLight spot_light;
+
+  // Clusters along x, y and depth, then the point light count
+  glm::uvec4 cluster_count;
+
+  // A fragment's depth slice is log(depth) * x + y
+  glm::vec4 cluster_depth;
+};
+
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock does not match its std140 layout");
+static_assert(sizeof(DirLight) == 64, "DirLight does not match its std140 layout");
+static_assert(sizeof(PointLight) == 64, "PointLight does not match its std140 layout");
+static_assert(sizeof(SpotLight) == 80, "SpotLight does not match its std140 layout");
+static_assert(offsetof(LightBlock, cluster_count) == 144, "LightBlock does not match its std140 layout");
+static_assert(sizeof(LightBlock) == 176, "LightBlock does not match its std140 layout");
+
+#endif /* uniform_blocks_h */
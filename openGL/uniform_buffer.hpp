@@ -0,0 +1,142 @@
+//
+//  uniform_buffer.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef uniform_buffer_h
+#define uniform_buffer_h
+
+// System Includes
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Local Includes
+#include "dynamic_ring_buffer.hpp"
+#include "gl_state_cache.hpp"
+#include "render_stats.hpp"
+
+// Alignment GL requires of the offset a uniform block is bound at
+inline std::size_t get_uniform_offset_alignment() {
+  static const std::size_t alignment = [] {
+    GLint value = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &value);
+    return value > 0 ? static_cast<std::size_t>(value) : RING_MAX_ALIGNMENT;
+  }();
+  return alignment;
+}
+
+// A uniform buffer object holding one std140 block. Keeps a CPU shadow of the block so that only the bytes
+// that actually changed since the last flush are sent to the GPU, in a single glBufferSubData call. Blocks that
+// change every frame can be streamed through a DynamicRingBuffer instead
+template <typename Block>
+class UniformBuffer {
+  static_assert(std::is_trivially_copyable<Block>::value, "Uniform blocks must be plain std140 structs");
+
+public:
+  // Ctor
+  explicit UniformBuffer(const unsigned int binding)
+  : binding_(binding) {
+    std::memset(&shadow_, 0, sizeof(Block));
+    glGenBuffers(1, &id_);
+    gl_state().bind_buffer(GL_UNIFORM_BUFFER, id_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &shadow_, GL_DYNAMIC_DRAW);
+    gl_state().bind_buffer_range(GL_UNIFORM_BUFFER, binding_, id_, 0, sizeof(Block));
+  }
+
+  // Dtor
+  ~UniformBuffer() {
+    gl_state().forget_buffer(id_);
+    glDeleteBuffers(1, &id_);
+  }
+
+  UniformBuffer(const UniformBuffer&) = delete;
+  UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+  // Copies the block into the shadow and widens the dirty range to cover whatever differs
+  void update(const Block &block) {
+    const unsigned char *next = reinterpret_cast<const unsigned char*>(&block);
+    unsigned char *current = reinterpret_cast<unsigned char*>(&shadow_);
+
+    std::size_t first = 0;
+    while (first < sizeof(Block) && next[first] == current[first]) {
+      ++first;
+    }
+    if (first == sizeof(Block)) {
+      return;
+    }
+
+    std::size_t last = sizeof(Block);
+    while (last > first && next[last - 1] == current[last - 1]) {
+      --last;
+    }
+
+    std::memcpy(current + first, next + first, last - first);
+    mark_dirty(first, last);
+  }
+
+  // Sends the dirty range, if any, to the GPU. Returns the number of upload calls made
+  int flush() {
+    if (dirty_begin_ >= dirty_end_) {
+      return 0;
+    }
+
+    ++render_stats().uniform_calls;
+    gl_state().bind_buffer(GL_UNIFORM_BUFFER, id_);
+    glBufferSubData(GL_UNIFORM_BUFFER, dirty_begin_, dirty_end_ - dirty_begin_,
+                    reinterpret_cast<const unsigned char*>(&shadow_) + dirty_begin_);
+
+    dirty_begin_ = sizeof(Block);
+    dirty_end_ = 0;
+    return 1;
+  }
+
+  // Copies the whole shadow into this frame's segment of the ring and binds the block there, so the copy never
+  // waits on draws still reading an earlier frame's values. The segment is recycled a few frames later, which is
+  // why this has to run every frame whether or not anything changed. Returns the number of upload calls made
+  int stream(DynamicRingBuffer &ring) {
+    const RingAllocation allocation = ring.allocate(sizeof(Block), get_uniform_offset_alignment());
+    if (allocation.data == nullptr) {
+      // The block's own buffer has missed every streamed change, so all of it goes out
+      mark_dirty(0, sizeof(Block));
+      gl_state().bind_buffer_range(GL_UNIFORM_BUFFER, binding_, id_, 0, sizeof(Block));
+      return flush();
+    }
+
+    ++render_stats().uniform_calls;
+    std::memcpy(allocation.data, &shadow_, sizeof(Block));
+    gl_state().bind_buffer_range(GL_UNIFORM_BUFFER, binding_, ring.get_id(), allocation.offset, sizeof(Block));
+    dirty_begin_ = sizeof(Block);
+    dirty_end_ = 0;
+    return 1;
+  }
+
+  const Block& get() const {
+    return shadow_;
+  }
+
+  unsigned int get_binding() const {
+    return binding_;
+  }
+
+private:
+  void mark_dirty(const std::size_t begin, const std::size_t end) {
+    if (begin < dirty_begin_) {
+      dirty_begin_ = begin;
+    }
+    if (end > dirty_end_) {
+      dirty_end_ = end;
+    }
+  }
+
+  unsigned int id_ = 0;
+  unsigned int binding_ = 0;
+  Block shadow_;
+  std::size_t dirty_begin_ = sizeof(Block);
+  std::size_t dirty_end_ = 0;
+};
+
+#endif /* uniform_buffer_h */
@@ -0,0 +1,203 @@
+//
+//  vertex_format.hpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+#ifndef vertex_format_h
+#define vertex_format_h
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Local Includes
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/packing.hpp"
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+#include <emmintrin.h>
+#endif
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// Interleaved vertex as meshes are built and loaded
+struct Vertex {
+  glm::vec3 position;
+  glm::vec3 normal;
+  glm::vec2 tex_coords;
+};
+
+static_assert(sizeof(Vertex) == 32, "Vertex must be tightly packed");
+
+// Half the size of Vertex, this is what meshes keep on the GPU:
+//  - position as unsigned normalized 16-bit relative to the mesh bounds, w is padding
+//  - normal octahedral encoded in two signed normalized 16-bit components
+//  - texture coordinates as half floats
+struct PackedVertex {
+  std::uint16_t position[4];
+  std::uint32_t normal;
+  std::uint32_t tex_coords;
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be tightly packed");
+
+// Axis aligned box the positions are quantized in
+struct VertexBounds {
+  glm::vec3 min = glm::vec3(0.0f);
+  glm::vec3 extent = glm::vec3(1.0f);
+};
+
+inline VertexBounds compute_vertex_bounds(const Vertex *vertices, const std::size_t count) {
+  VertexBounds bounds;
+  if (count == 0) {
+    return bounds;
+  }
+
+  glm::vec3 low = vertices[0].position;
+  glm::vec3 high = vertices[0].position;
+  for (std::size_t i = 1; i < count; i++) {
+    low = glm::min(low, vertices[i].position);
+    high = glm::max(high, vertices[i].position);
+  }
+  bounds.min = low;
+
+  // A flat axis still needs a non-zero extent to divide by
+  bounds.extent = glm::max(high - low, glm::vec3(1e-6f));
+  return bounds;
+}
+
+// Maps the [0, 1] positions the vertex shader reads back to model space. Appended to the model matrix so the
+// shader needs no extra work
+inline glm::mat4 get_dequantize_matrix(const VertexBounds &bounds) {
+  return glm::scale(glm::translate(glm::mat4(1.0f), bounds.min), bounds.extent);
+}
+
+// Centres the bounds on the origin and scales their longest side to 1, so a model of any size can stand in for
+// the unit cube
+inline glm::mat4 get_unit_fit_matrix(const VertexBounds &bounds) {
+  const float longest = std::max(bounds.extent.x, std::max(bounds.extent.y, bounds.extent.z));
+  return glm::translate(glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / longest)),
+                        -(bounds.min + bounds.extent * 0.5f));
+}
+
+// Folds a unit sphere onto an octahedron and unfolds the lower half into the corners of the square
+inline glm::vec2 encode_octahedral(const glm::vec3 &normal) {
+  const glm::vec3 n = normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+  if (n.z >= 0.0f) {
+    return glm::vec2(n.x, n.y);
+  }
+  return glm::vec2((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                   (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+inline PackedVertex encode_vertex(const Vertex &vertex, const VertexBounds &bounds) {
+  PackedVertex packed;
+  const glm::vec3 normalized = (vertex.position - bounds.min) / bounds.extent;
+  const std::uint64_t position = glm::packUnorm4x16(glm::vec4(normalized, 0.0f));
+  std::memcpy(packed.position, &position, sizeof(packed.position));
+  packed.normal = glm::packSnorm2x16(encode_octahedral(vertex.normal));
+  packed.tex_coords = glm::packHalf2x16(vertex.tex_coords);
+  return packed;
+}
+
+// Encodes count vertices. Four at a time with SSE2 where GLM has it compiled in, with F16C for the half floats
+// if the compiler targets it, and glm's scalar packing for the rest
+inline void encode_vertices(const Vertex *vertices, const std::size_t count, const VertexBounds &bounds,
+                            PackedVertex *out) {
+  std::size_t i = 0;
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+  const __m128 min_x = _mm_set1_ps(bounds.min.x);
+  const __m128 min_y = _mm_set1_ps(bounds.min.y);
+  const __m128 min_z = _mm_set1_ps(bounds.min.z);
+  const __m128 scale_x = _mm_set1_ps(65535.0f / bounds.extent.x);
+  const __m128 scale_y = _mm_set1_ps(65535.0f / bounds.extent.y);
+  const __m128 scale_z = _mm_set1_ps(65535.0f / bounds.extent.z);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 unorm_max = _mm_set1_ps(65535.0f);
+  const __m128 snorm_max = _mm_set1_ps(32767.0f);
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+  for (; i + 4 <= count; i += 4) {
+    // Each Vertex is two rows of four floats, transposing turns four of them into one register per component
+    const float *base = &vertices[i].position.x;
+    __m128 px = _mm_loadu_ps(base);
+    __m128 py = _mm_loadu_ps(base + 8);
+    __m128 pz = _mm_loadu_ps(base + 16);
+    __m128 nx = _mm_loadu_ps(base + 24);
+    _MM_TRANSPOSE4_PS(px, py, pz, nx);
+    __m128 ny = _mm_loadu_ps(base + 4);
+    __m128 nz = _mm_loadu_ps(base + 12);
+    __m128 u = _mm_loadu_ps(base + 20);
+    __m128 v = _mm_loadu_ps(base + 28);
+    _MM_TRANSPOSE4_PS(ny, nz, u, v);
+
+    // Positions, scaled into [0, 65535] and rounded
+    const __m128 qx = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(px, min_x), scale_x), zero), unorm_max);
+    const __m128 qy = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(py, min_y), scale_y), zero), unorm_max);
+    const __m128 qz = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(pz, min_z), scale_z), zero), unorm_max);
+    alignas(16) std::int32_t position[3][4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(position[0]), _mm_cvtps_epi32(qx));
+    _mm_store_si128(reinterpret_cast<__m128i*>(position[1]), _mm_cvtps_epi32(qy));
+    _mm_store_si128(reinterpret_cast<__m128i*>(position[2]), _mm_cvtps_epi32(qz));
+
+    // Octahedral normals
+    const __m128 ax = _mm_andnot_ps(sign_mask, nx);
+    const __m128 ay = _mm_andnot_ps(sign_mask, ny);
+    const __m128 az = _mm_andnot_ps(sign_mask, nz);
+    const __m128 inverse_l1 = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(ax, ay), az));
+    const __m128 ox = _mm_mul_ps(nx, inverse_l1);
+    const __m128 oy = _mm_mul_ps(ny, inverse_l1);
+    const __m128 sign_x = _mm_or_ps(_mm_and_ps(ox, sign_mask), one);
+    const __m128 sign_y = _mm_or_ps(_mm_and_ps(oy, sign_mask), one);
+    const __m128 fold_x = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, oy)), sign_x);
+    const __m128 fold_y = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(sign_mask, ox)), sign_y);
+    const __m128 lower = _mm_cmplt_ps(nz, zero);
+    const __m128 ex = _mm_or_ps(_mm_and_ps(lower, fold_x), _mm_andnot_ps(lower, ox));
+    const __m128 ey = _mm_or_ps(_mm_and_ps(lower, fold_y), _mm_andnot_ps(lower, oy));
+
+    // Signed normalized, x in the low half of each word and y in the high half
+    const __m128i sx = _mm_cvtps_epi32(_mm_mul_ps(ex, snorm_max));
+    const __m128i sy = _mm_cvtps_epi32(_mm_mul_ps(ey, snorm_max));
+    alignas(16) std::uint32_t normal[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(normal),
+                    _mm_or_si128(_mm_and_si128(sx, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(sy, 16)));
+
+#if defined(__F16C__)
+    // Half floats, u and v interleaved into one 32-bit word per vertex
+    alignas(16) std::uint32_t tex_coords[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(tex_coords),
+                    _mm_unpacklo_epi16(_mm_cvtps_ph(u, _MM_FROUND_TO_NEAREST_INT),
+                                       _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT)));
+#endif
+
+    for (int k = 0; k < 4; k++) {
+      PackedVertex &packed = out[i + k];
+      packed.position[0] = static_cast<std::uint16_t>(position[0][k]);
+      packed.position[1] = static_cast<std::uint16_t>(position[1][k]);
+      packed.position[2] = static_cast<std::uint16_t>(position[2][k]);
+      packed.position[3] = 0;
+      packed.normal = normal[k];
+#if defined(__F16C__)
+      packed.tex_coords = tex_coords[k];
+#else
+      packed.tex_coords = glm::packHalf2x16(vertices[i + k].tex_coords);
+#endif
+    }
+  }
+#endif
+
+  for (; i < count; i++) {
+    out[i] = encode_vertex(vertices[i], bounds);
+  }
+}
+
+#endif /* vertex_format_h */
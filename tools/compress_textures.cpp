@@ -0,0 +1,145 @@
+//
+//  compress_textures.cpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+// Offline texture compressor. Turns images into KTX files with a full, prebuilt mip chain that the texture
+// cache picks up in place of the originals:
+//
+//   compress_textures [--etc2] [--normal-map] [--output dir] image...
+//
+// Opaque images become BC1, images with alpha BC3 and normal maps BC5. With --etc2 they become ETC2 RGB8, ETC2
+// RGBA8 and EAC RG11 instead, for GPUs without S3TC. Each image.png is written as image.ktx
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Local Includes
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#undef STB_IMAGE_IMPLEMENTATION
+#include "block_compression.hpp"
+#include "ktx.hpp"
+
+// Command line options
+struct Options {
+  bool etc2 = false;
+  bool normal_map = false;
+  std::string output_directory;
+  std::vector<std::string> inputs;
+};
+
+Options parse_options(const int argc, const char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--etc2") == 0) {
+      options.etc2 = true;
+    }
+    else if (std::strcmp(argv[i], "--normal-map") == 0) {
+      options.normal_map = true;
+    }
+    else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+      options.output_directory = argv[++i];
+    }
+    else {
+      options.inputs.push_back(argv[i]);
+    }
+  }
+  return options;
+}
+
+// image.png becomes image.ktx, next to the input unless an output directory was given
+std::string output_path(const std::string &input, const std::string &output_directory) {
+  const std::size_t slash = input.find_last_of("/\\");
+  const std::size_t dot = input.find_last_of('.');
+  const std::size_t stem_end = dot != std::string::npos && (slash == std::string::npos || dot > slash) ? dot
+                                                                                                       : input.size();
+  if (output_directory.empty()) {
+    return input.substr(0, stem_end) + ".ktx";
+  }
+  const std::size_t stem_begin = slash == std::string::npos ? 0 : slash + 1;
+  return output_directory + "/" + input.substr(stem_begin, stem_end - stem_begin) + ".ktx";
+}
+
+std::uint32_t choose_format(const Options &options, const unsigned char *rgba, const std::size_t texels) {
+  if (options.normal_map) {
+    return options.etc2 ? KTX_COMPRESSED_RG11_EAC : KTX_COMPRESSED_RG_RGTC2;
+  }
+
+  bool opaque = true;
+  for (std::size_t i = 0; i < texels && opaque; i++) {
+    opaque = rgba[i * 4 + 3] == 255;
+  }
+  if (options.etc2) {
+    return opaque ? KTX_COMPRESSED_RGB8_ETC2 : KTX_COMPRESSED_RGBA8_ETC2_EAC;
+  }
+  return opaque ? KTX_COMPRESSED_RGB_S3TC_DXT1 : KTX_COMPRESSED_RGBA_S3TC_DXT5;
+}
+
+const char* format_name(const std::uint32_t internal_format) {
+  switch (internal_format) {
+    case KTX_COMPRESSED_RGB_S3TC_DXT1:
+      return "BC1";
+    case KTX_COMPRESSED_RGBA_S3TC_DXT5:
+      return "BC3";
+    case KTX_COMPRESSED_RG_RGTC2:
+      return "BC5";
+    case KTX_COMPRESSED_RG11_EAC:
+      return "EAC RG11";
+    case KTX_COMPRESSED_RGB8_ETC2:
+      return "ETC2 RGB8";
+    case KTX_COMPRESSED_RGBA8_ETC2_EAC:
+      return "ETC2 RGBA8";
+    default:
+      return "unknown";
+  }
+}
+
+int main(const int argc, const char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  if (options.inputs.empty()) {
+    std::cerr << "Usage: compress_textures [--etc2] [--normal-map] [--output dir] image...\n";
+    return 1;
+  }
+
+  int failures = 0;
+  for (const std::string &input : options.inputs) {
+    const auto start = std::chrono::steady_clock::now();
+
+    // Always expand to RGBA, the encoders ignore whatever channels their format does not store
+    int width, height, nr_components;
+    unsigned char *rgba = stbi_load(input.c_str(), &width, &height, &nr_components, 4);
+    if (rgba == nullptr) {
+      std::cerr << "Could not decode " << input << "\n";
+      ++failures;
+      continue;
+    }
+
+    const std::uint32_t internal_format = choose_format(options, rgba, static_cast<std::size_t>(width) * height);
+    const KtxImage image = block_compression::compress_image(internal_format, rgba, width, height);
+    stbi_image_free(rgba);
+
+    const std::string output = output_path(input, options.output_directory);
+    if (!write_ktx(output, image)) {
+      std::cerr << "Could not write " << output << "\n";
+      ++failures;
+      continue;
+    }
+
+    // What the same image costs uncompressed as RGBA8 with a generated mip chain
+    const std::size_t uncompressed = static_cast<std::size_t>(width) * height * 4 * 4 / 3;
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << input << " -> " << output << ": " << format_name(internal_format) << ", " << width << "x" << height
+              << ", " << image.levels.size() << " levels, " << image.get_bytes() / 1024 << " KB (was "
+              << uncompressed / 1024 << " KB) in " << seconds * 1000.0 << " ms\n";
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+//
+//  cull_benchmark.cpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+// Frustum culling throughput, without a GPU in the way:
+//
+//   cull_benchmark [--objects N] [--frames N] [--rays N]
+//
+// Scatters N boxes and spheres (a million by default) through a volume and turns a camera inside it, culling
+// everything once per frame with the scalar and the SIMD kernels and through a bounding volume hierarchy. All
+// have to agree on what is visible. Then rays are cast from the camera into growing subsets of the boxes, by
+// testing every box and through a hierarchy, to show how both scale. They have to agree on what is hit
+
+// System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Local Includes
+#include "bvh.hpp"
+#include "frustum.hpp"
+#include "glm/glm.hpp"
+#include "glm/gtc/constants.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// Command line options
+struct Options {
+  std::size_t object_count = 1000000;
+  std::size_t frame_count = 100;
+  std::size_t ray_count = 1000;
+};
+
+Options parse_options(const int argc, const char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--objects") == 0 && i + 1 < argc) {
+      options.object_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      options.frame_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--rays") == 0 && i + 1 < argc) {
+      options.ray_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else {
+      std::cerr << "Unknown option: " << argv[i] << "\n";
+    }
+  }
+  return options;
+}
+
+// The camera spins on the spot in the middle of the volume, so about as much is visible every frame
+Frustum frame_frustum(const std::size_t frame, const std::size_t frame_count) {
+  const float angle = 2.0f * glm::pi<float>() * static_cast<float>(frame) / static_cast<float>(frame_count);
+  const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+  const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(std::cos(angle), 0.2f, std::sin(angle)),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+  return Frustum::from_matrix(projection * view);
+}
+
+// Runs cull once per frame and reports the time per frame and per object. Returns the visible count of every
+// frame for comparison
+template <typename Cull>
+std::vector<std::size_t> run(const char *name, const Options &options, Cull cull) {
+  std::vector<std::size_t> visible_counts(options.frame_count);
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t frame = 0; frame < options.frame_count; frame++) {
+    visible_counts[frame] = cull(frame_frustum(frame, options.frame_count));
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::size_t visible = 0;
+  for (const std::size_t count : visible_counts) {
+    visible += count;
+  }
+  const double frames = static_cast<double>(options.frame_count);
+  std::cout << "  " << name << ": " << seconds * 1000.0 / frames << " ms per frame, "
+            << seconds * 1.0e9 / (frames * options.object_count) << " ns per object, "
+            << static_cast<double>(visible) / frames << " visible\n";
+  return visible_counts;
+}
+
+// Closest box along a ray by testing every one of the first count boxes
+bool raycast_linear(const std::vector<Aabb> &boxes, const std::size_t count, const glm::vec3 &origin,
+                    const glm::vec3 &direction, std::uint32_t &object, float &distance) {
+  const glm::vec3 inverse_direction = 1.0f / direction;
+  distance = std::numeric_limits<float>::max();
+  bool hit = false;
+  for (std::size_t i = 0; i < count; i++) {
+    const float enter = boxes[i].intersect_ray(origin, inverse_direction, distance);
+    if (enter >= 0.0f && enter < distance) {
+      distance = enter;
+      object = static_cast<std::uint32_t>(i);
+      hit = true;
+    }
+  }
+  return hit;
+}
+
+// Casts the same rays at growing subsets of the boxes, once by testing every box and once through a hierarchy
+// built over the subset. Returns false if the two ever hit different boxes
+bool run_picking(const Options &options, const std::vector<Aabb> &boxes) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> axis(-1.0f, 1.0f);
+  std::vector<glm::vec3> directions(options.ray_count);
+  for (glm::vec3 &direction : directions) {
+    direction = glm::normalize(glm::vec3(axis(random), axis(random), axis(random)) + glm::vec3(0.0f, 0.0f, 1e-3f));
+  }
+
+  using clock = std::chrono::steady_clock;
+  const auto nanoseconds_per_ray = [&options](const clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(clock::now() - start).count() / options.ray_count;
+  };
+
+  bool agree = true;
+  for (std::size_t count = std::min<std::size_t>(1000, boxes.size()); ; count = std::min(count * 10, boxes.size())) {
+    const std::vector<Aabb> subset(boxes.begin(), boxes.begin() + count);
+    Bvh hierarchy;
+    const auto build_start = clock::now();
+    hierarchy.build(subset);
+    const double build_ms = std::chrono::duration<double, std::milli>(clock::now() - build_start).count();
+
+    std::vector<std::uint32_t> linear_hits(options.ray_count, UINT32_MAX);
+    const auto linear_start = clock::now();
+    for (std::size_t i = 0; i < options.ray_count; i++) {
+      float distance = 0.0f;
+      raycast_linear(subset, count, glm::vec3(0.0f), directions[i], linear_hits[i], distance);
+    }
+    const double linear_ns = nanoseconds_per_ray(linear_start);
+
+    std::vector<std::uint32_t> hierarchy_hits(options.ray_count, UINT32_MAX);
+    const auto hierarchy_start = clock::now();
+    for (std::size_t i = 0; i < options.ray_count; i++) {
+      const glm::vec3 inverse_direction = 1.0f / directions[i];
+      float distance = 0.0f;
+      hierarchy.raycast(glm::vec3(0.0f), directions[i], [&](const std::uint32_t object, float &hit) {
+        hit = subset[object].intersect_ray(glm::vec3(0.0f), inverse_direction, std::numeric_limits<float>::max());
+        return hit >= 0.0f;
+      }, hierarchy_hits[i], distance);
+    }
+    const double hierarchy_ns = nanoseconds_per_ray(hierarchy_start);
+
+    std::cout << "  " << count << " boxes: linear " << linear_ns << " ns per ray, hierarchy " << hierarchy_ns
+              << " ns per ray (" << hierarchy.get_nodes().size() << " nodes, depth " << hierarchy.get_depth()
+              << ", built in " << build_ms << " ms)\n";
+    agree = agree && linear_hits == hierarchy_hits;
+    if (count == boxes.size()) {
+      return agree;
+    }
+  }
+}
+
+int main(const int argc, const char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  if (options.object_count == 0 || options.frame_count == 0) {
+    std::cerr << "Usage: cull_benchmark [--objects N] [--frames N]\n";
+    return 1;
+  }
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+  std::uniform_real_distribution<float> size(0.25f, 2.0f);
+  BoxArray boxes;
+  SphereArray spheres;
+  std::vector<Aabb> box_bounds(options.object_count);
+  boxes.reserve(options.object_count);
+  for (std::size_t i = 0; i < options.object_count; i++) {
+    const glm::vec3 center(position(random), position(random), position(random));
+    const glm::vec3 extent(size(random), size(random), size(random));
+    boxes.push_back(center, extent);
+    spheres.push_back(center, glm::length(extent));
+    box_bounds[i] = Aabb(center - extent, center + extent);
+  }
+  std::vector<std::uint32_t> visible(options.object_count);
+
+#if defined(__AVX__)
+  const char *simd = "AVX";
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+  const char *simd = "SSE";
+#else
+  const char *simd = "no SIMD";
+#endif
+  std::cout << "Culling " << options.object_count << " objects over " << options.frame_count << " frames ("
+            << simd << ")\n";
+
+  const std::vector<std::size_t> box_reference = run("boxes, scalar", options, [&](const Frustum &frustum) {
+    return cull_boxes_scalar(frustum, boxes, visible.data());
+  });
+  const std::vector<std::size_t> box_wide = run("boxes, SIMD  ", options, [&](const Frustum &frustum) {
+    return cull_boxes(frustum, boxes, visible.data());
+  });
+  const std::vector<std::size_t> sphere_reference = run("spheres, scalar", options, [&](const Frustum &frustum) {
+    return cull_spheres_scalar(frustum, spheres, visible.data());
+  });
+  const std::vector<std::size_t> sphere_wide = run("spheres, SIMD  ", options, [&](const Frustum &frustum) {
+    return cull_spheres(frustum, spheres, visible.data());
+  });
+
+  Bvh hierarchy;
+  const auto build_start = std::chrono::steady_clock::now();
+  hierarchy.build(boxes);
+  std::cout << "  hierarchy of " << hierarchy.get_nodes().size() << " nodes, depth " << hierarchy.get_depth()
+            << ", built in "
+            << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - build_start).count()
+            << " ms\n";
+  std::vector<std::uint32_t> hierarchy_visible;
+  hierarchy_visible.reserve(options.object_count);
+  const std::vector<std::size_t> box_hierarchy = run("boxes, hierarchy", options, [&](const Frustum &frustum) {
+    hierarchy_visible.clear();
+    hierarchy.cull(frustum, hierarchy_visible);
+    return hierarchy_visible.size();
+  });
+
+  if (box_reference != box_wide || sphere_reference != sphere_wide) {
+    std::cerr << "SIMD and scalar culling disagree\n";
+    return 1;
+  }
+  if (box_reference != box_hierarchy) {
+    std::cerr << "Hierarchy and scalar culling disagree\n";
+    return 1;
+  }
+
+  std::cout << "Picking with " << options.ray_count << " rays\n";
+  if (options.ray_count > 0 && !run_picking(options, box_bounds)) {
+    std::cerr << "Hierarchy and linear picking disagree\n";
+    return 1;
+  }
+  return 0;
+}
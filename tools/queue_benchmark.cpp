@@ -0,0 +1,142 @@
+//
+//  queue_benchmark.cpp
+//  openGL
+//
+//  Created by Ian Holdeman on 10/17/26.
+//  Copyright © 2026 Marvin LLC. All rights reserved.
+//
+
+// Render queue sort throughput, without a GPU in the way:
+//
+//   queue_benchmark [--draws N] [--frames N] [--programs N] [--materials N]
+//
+// Queues N draws (a hundred thousand by default) spread over a few programs, materials and meshes at random
+// depths, then sorts and batches them once per frame with the queue's radix sort and with std::sort on the same
+// keys. Both have to agree on the order of the keys
+
+// System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Local Includes
+#include "render_queue.hpp"
+
+// Command line options
+struct Options {
+  std::size_t draw_count = 100000;
+  std::size_t frame_count = 100;
+  std::uint32_t program_count = 4;
+  std::uint32_t material_count = 64;
+};
+
+Options parse_options(const int argc, const char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--draws") == 0 && i + 1 < argc) {
+      options.draw_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      options.frame_count = std::strtoul(argv[++i], nullptr, 10);
+    }
+    else if (std::strcmp(argv[i], "--programs") == 0 && i + 1 < argc) {
+      options.program_count = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if (std::strcmp(argv[i], "--materials") == 0 && i + 1 < argc) {
+      options.material_count = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else {
+      std::cerr << "Unknown option: " << argv[i] << "\n";
+    }
+  }
+  options.program_count = std::max(1u, std::min(options.program_count, SORT_KEY_PROGRAM_MASK + 1));
+  options.material_count = std::max(1u, std::min(options.material_count, SORT_KEY_MATERIAL_MASK + 1));
+  return options;
+}
+
+// A frame's worth of keys, seeded by the frame. One draw in ten is unlit, the rest opaque
+std::vector<std::uint64_t> build_keys(const Options &options, const std::size_t frame) {
+  std::mt19937 random(static_cast<std::uint32_t>(frame));
+  std::uniform_int_distribution<std::uint32_t> program(0, options.program_count - 1);
+  std::uniform_int_distribution<std::uint32_t> material(0, options.material_count - 1);
+  std::uniform_int_distribution<std::uint32_t> mesh(0, 7);
+  std::uniform_real_distribution<float> depth(0.1f, 100.0f);
+  std::uniform_int_distribution<int> pass(0, 9);
+
+  std::vector<std::uint64_t> keys(options.draw_count);
+  for (std::uint64_t &key : keys) {
+    key = make_sort_key(pass(random) == 0 ? RENDER_PASS_UNLIT : RENDER_PASS_OPAQUE, program(random),
+                        material(random), mesh(random), depth(random));
+  }
+  return keys;
+}
+
+int main(const int argc, const char *argv[]) {
+  const Options options = parse_options(argc, argv);
+  std::cout << options.draw_count << " draws over " << options.program_count << " programs and "
+            << options.material_count << " materials, " << options.frame_count << " frames\n";
+
+  std::vector<std::vector<std::uint64_t>> frame_keys(options.frame_count);
+  for (std::size_t frame = 0; frame < options.frame_count; frame++) {
+    frame_keys[frame] = build_keys(options, frame);
+  }
+
+  RenderQueue queue;
+  queue.reserve(options.draw_count);
+  std::vector<RenderItem> reference;
+  reference.reserve(options.draw_count);
+  double radix_seconds = 0.0;
+  double std_seconds = 0.0;
+  std::size_t batch_count = 0;
+  std::size_t sort_passes = 0;
+  std::size_t mismatches = 0;
+
+  for (std::size_t frame = 0; frame < options.frame_count; frame++) {
+    const std::vector<std::uint64_t> &keys = frame_keys[frame];
+
+    auto start = std::chrono::steady_clock::now();
+    queue.clear();
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      queue.push(keys[i], static_cast<std::uint32_t>(i));
+    }
+    queue.sort();
+    radix_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    batch_count += queue.get_batches().size();
+    sort_passes += queue.get_sort_passes();
+
+    start = std::chrono::steady_clock::now();
+    reference.clear();
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      reference.push_back(RenderItem{keys[i], static_cast<std::uint32_t>(i)});
+    }
+    std::sort(reference.begin(), reference.end(), [](const RenderItem &a, const RenderItem &b) {
+      return a.key < b.key;
+    });
+    std_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const std::vector<RenderItem> &items = queue.get_items();
+    for (std::size_t i = 0; i < items.size(); i++) {
+      if (items[i].key != reference[i].key) {
+        ++mismatches;
+      }
+    }
+  }
+
+  const double frames = static_cast<double>(std::max<std::size_t>(options.frame_count, 1));
+  const double draws = frames * static_cast<double>(std::max<std::size_t>(options.draw_count, 1));
+  std::cout << "  radix sort    " << radix_seconds * 1000.0 / frames << " ms per frame, "
+            << radix_seconds * 1.0e9 / draws << " ns per draw, " << sort_passes / frames << " passes, "
+            << batch_count / frames << " batches\n";
+  std::cout << "  std::sort     " << std_seconds * 1000.0 / frames << " ms per frame, "
+            << std_seconds * 1.0e9 / draws << " ns per draw\n";
+  if (mismatches != 0) {
+    std::cerr << "Sorted orders disagree at " << mismatches << " positions\n";
+    return 1;
+  }
+  return 0;
+}